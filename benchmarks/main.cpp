@@ -0,0 +1,43 @@
+/*
+ * main.cpp – runs the solver benchmarks from debug_utils/benchmark.h without opening a window
+ */
+
+#include "debug_utils/benchmark.h"
+#include <cstdlib>
+#include <cstring>
+
+// numeric argument i after the benchmark name, or fallback if it wasn't given
+static int arg(int argc, char** argv, int i, int fallback) {
+    return argc > i + 1 ? std::atoi(argv[i + 1]) : fallback;
+}
+
+int main(int argc, char** argv) {
+    const char* name = argc > 1 ? argv[1] : "all";
+    bool all = std::strcmp(name, "all") == 0;
+    bool ok = true;
+    bool ran = false;
+
+    if (all || std::strcmp(name, "solve") == 0) {
+        ok &= benchmarkSolve(arg(argc, argv, 1, 100000));
+        ran = true;
+    }
+    if (all || std::strcmp(name, "convergence") == 0) {
+        benchmarkConvergence(arg(argc, argv, 1, 20), arg(argc, argv, 2, 120));
+        ran = true;
+    }
+    if (all || std::strcmp(name, "reorder") == 0) {
+        benchmarkReorder(arg(argc, argv, 1, 20), arg(argc, argv, 2, 4), arg(argc, argv, 3, 300));
+        ran = true;
+    }
+    if (all || std::strcmp(name, "snapshot") == 0) {
+        ok &= benchmarkSnapshot(arg(argc, argv, 1, 1000), arg(argc, argv, 2, 100));
+        ran = true;
+    }
+
+    if (!ran) {
+        std::cerr << "usage: benchmark [all | solve [samples] | convergence [iterations] [steps] | "
+                     "reorder [side] [height] [steps] | snapshot [bodies] [repeats]]" << std::endl;
+        return 2;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+#include "solver.h"
+
+Rigid::Rigid(Solver* solver, const Rigid& other) : Rigid(other) {
+    this->solver = solver;
+}
+
+// Bodies and forces are copied into the same array slots and the handle tables are copied as they
+// are, so handles, ids and every iteration order of the original carry over. Links between bodies
+// and forces are then remapped through the array indices. Scratch memory is not copied since
+// nothing in it outlives a step
+std::unique_ptr<Solver> Solver::clone() const {
+    std::unique_ptr<Solver> copy(new Solver(pool));
+
+    copy->gravity = gravity;
+    copy->iterations = iterations;
+    copy->minIterations = minIterations;
+    copy->primalTolerance = primalTolerance;
+    copy->dualTolerance = dualTolerance;
+    copy->alpha = alpha;
+    copy->beta = beta;
+    copy->gamma = gamma;
+    copy->cacheConstraints = cacheConstraints;
+    copy->refreshInertia = refreshInertia;
+    copy->batchSolve = batchSolve;
+    copy->validate = validate;
+    copy->parallelIslands = parallelIslands;
+    copy->jacobi = jacobi;
+    copy->relaxation = relaxation;
+    copy->deterministic = deterministic;
+    copy->geometricStiffness = geometricStiffness;
+    copy->accelerate = accelerate;
+    copy->spectralRadius = spectralRadius;
+    copy->reorderInterval = reorderInterval;
+    copy->timestep = timestep;
+    copy->substeps = substeps;
+    copy->maxSteps = maxSteps;
+    copy->accumulator = accumulator;
+    copy->interpolation = interpolation;
+    copy->allowSleep = allowSleep;
+    copy->sleepLinearVelocity = sleepLinearVelocity;
+    copy->sleepAngularVelocity = sleepAngularVelocity;
+    copy->sleepTime = sleepTime;
+
+    copy->meshes = meshes;
+    copy->nextBodyId = nextBodyId;
+    copy->nextForceId = nextForceId;
+    copy->stepHash = stepHash;
+    copy->stepsSinceReorder = stepsSinceReorder;
+    copy->islandsDirty = islandsDirty;
+    copy->stepIterations = stepIterations;
+    copy->stepPrimalResidual = stepPrimalResidual;
+    copy->stepDualResidual = stepDualResidual;
+    copy->stepTimedOut = stepTimedOut;
+    copy->stepArenaBytes = stepArenaBytes;
+    copy->deadline = deadline;
+
+    copy->bodies.reserve(bodies.size());
+    for (const Rigid* body : bodies) copy->bodies.push_back(new Rigid(copy.get(), *body));
+    copy->forces.reserve(forces.size());
+    for (const Force* force : forces) copy->forces.push_back(force->clone(copy.get()));
+
+    Solver* target = copy.get();
+    auto body = [target](const Rigid* b) { return b ? target->bodies[b->index] : nullptr; };
+    auto force = [target](const Force* f) { return f ? target->forces[f->index] : nullptr; };
+
+    for (Rigid* b : copy->bodies) {
+        b->forces = force(b->forces);
+        b->islandParent = body(b->islandParent);
+    }
+    for (Force* f : copy->forces) {
+        f->bodyA = body(f->bodyA);
+        f->bodyB = body(f->bodyB);
+        f->nextA = force(f->nextA);
+        f->nextB = force(f->nextB);
+    }
+
+    copy->bodyHandles = bodyHandles;
+    copy->bodyHandles.remap(body);
+    copy->forceHandles = forceHandles;
+    copy->forceHandles.remap(force);
+
+    // wakeIsland reads the islands of the last step before the next one rebuilds them
+    copy->islands = islands;
+    for (Island& island : copy->islands) {
+        for (Rigid*& b : island.bodies) b = body(b);
+        for (Force*& f : island.forces) f = force(f);
+    }
+
+    return copy;
+}
@@ -33,42 +33,52 @@ SupportPoint getSupportPoint(Rigid* bodyA, Rigid* bodyB, const vec3& dir) {
 }
 
 // Main
-int Manifold::collide(Rigid* bodyA, Rigid* bodyB, Contact* contacts) {
+int Manifold::collide(Rigid* bodyA, Rigid* bodyB, ContactPoint* points) {
     // run collision detection
     Simplex simplex = Simplex(); // can prolly go on the stack idk, there's only one rn
     bool collided = gjk(bodyA, bodyB, simplex);
 
     if (!collided) return 0;
 
+    // everything below is scratch data for this pair, handed back to the arena once contacts are copied out
+    FrameArena& arena = bodyA->solver->frameArena();
+    FrameArena::Scope scope(arena);
+
     // run collision resolution
-    Polytope* polytope = new Polytope(simplex);
+    Polytope storage(simplex, arena);
+    Polytope* polytope = &storage;
+    if (polytope->pq.empty()) return 0; // degenerate simplex, no usable normal
     epa(bodyA, bodyB, polytope);
 
     if (hasNaN(polytope->front().normal)) std::runtime_error("normal has nan");
 
-    std::vector<vec3> rAs, rBs;
+    ArenaVector<vec3> rAs(arena), rBs(arena);
     int type = getContact(rAs, rBs, polytope, bodyA, bodyB);
 
     if (rAs.size() != rBs.size()) throw std::runtime_error("Contact point size missmatch");
 
     int size = glm::clamp((int) rAs.size(), 0, 4);
 
+    const Face& face = polytope->front();
     for (int i = 0; i < size; i++) {
         // compute contact information
-        contacts[i].normal = polytope->front().normal;
-        contacts[i].depth = polytope->front().distance * 10;
-        contacts[i].face = polytope->front();
-        contacts[i].rA = inverseTransform(rAs[i], bodyA);
-        contacts[i].rB = inverseTransform(rBs[i], bodyB);
-        contacts[i].type = type;
+        points[i].normal = face.normal;
+        points[i].rA = inverseTransform(rAs[i], bodyA);
+        points[i].rB = inverseTransform(rBs[i], bodyB);
+        points[i].type = type;
+
+        for (int j = 0; j < 3; j++) {
+            points[i].mink[j] = face.sps[j]->mink;
+            points[i].indexA[j] = face.sps[j]->indexA;
+            points[i].indexB[j] = face.sps[j]->indexB;
+        }
 
         if (hasNaN(rAs[i])) throw std::runtime_error("Contact point from rA has Nan");
         if (hasNaN(rBs[i])) throw std::runtime_error("Contact point from rB has Nan");
     }
 
     // ensure normal is facing the correct direction
-    for (int i = 0; i < size; i++) if (glm::dot(contacts[i].normal, bodyA->position - bodyB->position) < 0)  contacts[i].normal *= -1;
+    for (int i = 0; i < size; i++) if (glm::dot(points[i].normal, vec3(bodyA->position - bodyB->position)) < 0)  points[i].normal *= -1;
 
-    delete polytope;
     return size;
 }
\ No newline at end of file
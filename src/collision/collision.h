@@ -8,6 +8,7 @@
 #include "linalg/linalg.h"
 #include <cmath>
 #include <optional>
+#include <unordered_set>
 
 #define DEBUG_PRINT_GJK false
 
@@ -22,13 +23,13 @@ struct Compare {
     }
 };
 
-// polytope
+// polytope, all of its storage comes from the frame arena of the thread running the collision
 struct Polytope {
-    std::unordered_map<SupportPoint, std::shared_ptr<SupportPoint>, SupportPointHash, SupportPointEqual> sps;
-    std::set<Face, Compare> pq; // Min-heap based on face distance to origin
+    std::unordered_set<SupportPoint, SupportPointHash, SupportPointEqual, ArenaAllocator<SupportPoint>> sps; // nodes never move, so faces point into it
+    std::set<Face, Compare, ArenaAllocator<Face>> pq; // Min-heap based on face distance to origin
     vec3 vertTot; // used for tracking centroid when origin fails
 
-    Polytope(const Simplex& simplex);
+    Polytope(const Simplex& simplex, FrameArena& arena);
     ~Polytope();
     const SupportPoint* add(const SupportPoint& sp);
     void add(Face face);
@@ -50,11 +51,11 @@ bool      simplex4(Simplex& simplex, Rigid* bodyA, Rigid* bodyB, vec3& dir);
 bool gjk(Rigid* bodyA, Rigid* bodyB, Simplex& simplex);
 bool epa(Rigid* bodyA, Rigid* bodyB, Polytope* polytope);
 
-int getContact(std::vector<vec3>& rAs, std::vector<vec3>& rBs, Polytope* polytope, Rigid* bodyA, Rigid* bodyB);
+int getContact(ArenaVector<vec3>& rAs, ArenaVector<vec3>& rBs, Polytope* polytope, Rigid* bodyA, Rigid* bodyB);
 vec3 projectPointOntoPlane(const vec3& point, const vec3& normal, const vec3& planePoint);
 vec3 closestPointOnSegmentToVertex(const vec3& u0, const vec3& u1, const vec3& v);
 std::pair<vec3, vec3> closestPointBetweenSegments(const vec3& p0, const vec3& p1, const vec3& q0, const vec3& q1);
-void closestPointsOnTriangleToSegment(std::vector<vec3>& pts, const vec3& v0, const vec3& v1, const vec3& a, const vec3& b, const vec3& c);
-void clipFace(std::vector<vec3>& pts, const vec3& a0, const vec3& b0, const vec3& c0, const vec3& a1, const vec3& b1, const vec3& c1);
+void closestPointsOnTriangleToSegment(ArenaVector<vec3>& pts, const vec3& v0, const vec3& v1, const vec3& a, const vec3& b, const vec3& c);
+void clipFace(ArenaVector<vec3>& pts, const vec3& a0, const vec3& b0, const vec3& c0, const vec3& a1, const vec3& b1, const vec3& c1);
 
 #endif
\ No newline at end of file
@@ -109,7 +109,7 @@ vec3 closestPointOnTriangle(const vec3& a, const vec3& b, const vec3& c, const v
 }
 
 
-void fallbackContact(std::vector<vec3>& rAs, std::vector<vec3>& rBs, Polytope* polytope, Rigid* bodyA, Rigid* bodyB) {
+void fallbackContact(ArenaVector<vec3>& rAs, ArenaVector<vec3>& rBs, Polytope* polytope, Rigid* bodyA, Rigid* bodyB) {
     // vec renaming
     const vec3& a = polytope->front().sps[0]->mink;
     const vec3& b = polytope->front().sps[1]->mink;
@@ -206,7 +206,7 @@ affine getAffine(const std::array<const SupportPoint*, 3>& sps, bool isA) {
     return a;
 }
 
-vec3 avgVecs(const std::vector<vec3>& pts) {
+vec3 avgVecs(const ArenaVector<vec3>& pts) {
     if (pts.size() == 0) return vec3();
 
     vec3 v = vec3();
@@ -214,7 +214,7 @@ vec3 avgVecs(const std::vector<vec3>& pts) {
     return v / (float) pts.size();
 }
 
-int getContact(std::vector<vec3>& rAs, std::vector<vec3>& rBs, Polytope* polytope, Rigid* bodyA, Rigid* bodyB) {
+int getContact(ArenaVector<vec3>& rAs, ArenaVector<vec3>& rBs, Polytope* polytope, Rigid* bodyA, Rigid* bodyB) {
     // determine affine relationships
     affine affA = getAffine(polytope->front().sps, true);
     affine affB = getAffine(polytope->front().sps, false);
@@ -283,7 +283,7 @@ int getContact(std::vector<vec3>& rAs, std::vector<vec3>& rBs, Polytope* polytop
         return 4;
     }
 
-    std::vector<vec3> pts;
+    ArenaVector<vec3> pts(rAs.get_allocator());
 
     // check edge - face
     if (affA.dim == 1 && affB.dim == 2) {
@@ -96,7 +96,7 @@ bool isInsideEdge2d(const vec2& c0, const vec2& c1, const vec2& p) {
     return cross(c1 - c0, p - c0) >= 0;
 }
 
-void orderTriangle2d(std::vector<vec2>& vecs) {
+void orderTriangle2d(ArenaVector<vec2>& vecs) {
     float signedArea = 0;
     for (int i = 0; i < vecs.size(); i++) {
         vec2 p0 = vecs[i];
@@ -147,7 +147,7 @@ bool pointIsInTriangle2d(const vec2& p, const vec2& a, const vec2& b, const vec2
 }
 
 // line segment to triangle
-void closestPointsOnTriangleToSegment(std::vector<vec3>& pts, const vec3& v0, const vec3& v1, const vec3& a, const vec3& b, const vec3& c) {
+void closestPointsOnTriangleToSegment(ArenaVector<vec3>& pts, const vec3& v0, const vec3& v1, const vec3& a, const vec3& b, const vec3& c) {
     vec3 u, v;
     get2dBasis(u, v, a, b, c);
 
@@ -187,7 +187,7 @@ void closestPointsOnTriangleToSegment(std::vector<vec3>& pts, const vec3& v0, co
 }
 
 // check for no solution
-void clipFace(std::vector<vec3>& pts, const vec3& a0, const vec3& b0, const vec3& c0, const vec3& a1, const vec3& b1, const vec3& c1) {
+void clipFace(ArenaVector<vec3>& pts, const vec3& a0, const vec3& b0, const vec3& c0, const vec3& a1, const vec3& b1, const vec3& c1) {
     vec3 u, v;
     get2dBasis(u, v, a1, b1, c1);
 
@@ -199,8 +199,10 @@ void clipFace(std::vector<vec3>& pts, const vec3& a0, const vec3& b0, const vec3
     vec3 p2 = projectPointOntoPlane(c0, normal, a1);
 
     // convert points to 2d
-    std::vector<vec2> clipper = { project2d(u, v, a1, p0), project2d(u, v, a1, p1), project2d(u, v, a1, p2) };
-    std::vector<vec2> subject = { project2d(u, v, a1, a1), project2d(u, v, a1, b1), project2d(u, v, a1, c1) };
+    // clip polygons share the arena of the output points
+    ArenaAllocator<vec2> allocator = pts.get_allocator();
+    ArenaVector<vec2> clipper({ project2d(u, v, a1, p0), project2d(u, v, a1, p1), project2d(u, v, a1, p2) }, allocator);
+    ArenaVector<vec2> subject({ project2d(u, v, a1, a1), project2d(u, v, a1, b1), project2d(u, v, a1, c1) }, allocator);
 
     // order edges
     orderTriangle2d(clipper);
@@ -208,8 +210,8 @@ void clipFace(std::vector<vec3>& pts, const vec3& a0, const vec3& b0, const vec3
 
     // perform triangle - triangle intersection
     // sutherland-hodgeman
-    std::vector<vec2> output = { subject[0], subject[1], subject[2] };
-    std::vector<vec2> input;
+    ArenaVector<vec2> output({ subject[0], subject[1], subject[2] }, allocator);
+    ArenaVector<vec2> input(allocator);
     for (int c = 0; c < 3; c++) {
         input = output;
         output.clear();
@@ -9,18 +9,22 @@ bool sameDirection(const vec3& v1, const vec3& v2) {
     return glm::dot(v1, v2) > 0;
 }
 
-Polytope::Polytope(const Simplex& simplex) : sps(), pq(), vertTot(0) {
+Polytope::Polytope(const Simplex& simplex, FrameArena& arena) 
+    : sps(0, SupportPointHash(), SupportPointEqual(), ArenaAllocator<SupportPoint>(arena)), pq(Compare(), ArenaAllocator<Face>(arena)), vertTot(0) {
     // copy vertices from the simplex (Do not change to move, they will need to be saved in more efficient versions)
     for (int i = 0; i < 4; i++) add(simplex[i]);
 
-    // capture iterators or pointers for stable access
-    std::vector<const SupportPoint*> pts;
-    pts.reserve(4);  // avoid reallocations
-    for (const auto& [key, sptr] : sps) {
-        pts.push_back(sptr.get());
-        if (pts.size() == 4) break;
+    // capture pointers for stable access
+    std::array<const SupportPoint*, 4> pts = {};
+    int count = 0;
+    for (const SupportPoint& sp : sps) {
+        pts[count++] = &sp;
+        if (count == 4) break;
     }
 
+    // a simplex with repeated points encloses no volume, leave the polytope without faces
+    if (count < 4) return;
+
     // add faces with correct combinations
     add(buildFace(pts[0], pts[1], pts[2], true).value()); 
     add(buildFace(pts[0], pts[3], pts[1], true).value()); 
@@ -34,18 +38,8 @@ Polytope::~Polytope() {}
 const SupportPoint* Polytope::add(const SupportPoint& sp) {
     vertTot += sp.mink;
 
-    // Check if SupportPoint already exists
-    auto it = sps.find(sp);
-    if (it != sps.end()) {
-        // Already present, return stored pointer
-        return it->second.get();
-    }
-
-    // Not present, create new shared_ptr and insert
-    auto spPtr = std::make_shared<SupportPoint>(sp);
-    auto [insertedIt, inserted] = sps.emplace(*spPtr, spPtr);
-
-    return insertedIt->second.get();
+    // returns the stored point if it already exists
+    return &*sps.insert(sp).first;
 }
 
 void Polytope::add(Face face) { pq.insert(face); }
@@ -110,7 +104,7 @@ bool Polytope::insert(const SupportPoint& spRef) {
     const SupportPoint* sp = add(spRef);
 
     Edge edge;
-    std::set<Edge> edges;
+    std::set<Edge, EdgeCompare, ArenaAllocator<Edge>> edges(EdgeCompare(), ArenaAllocator<Edge>(pq.get_allocator()));
     // loop through every face
     for (auto it = pq.begin(); it != pq.end();) {
         const Face& face = *it;
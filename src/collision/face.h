@@ -18,16 +18,4 @@ struct Face {
     }
 };
 
-struct StackFace {
-    std::array<SupportPoint, 3> sps;
-    vec3 normal;
-    float distance;
-
-    StackFace(const Face& face) : sps(), normal(face.normal), distance(face.distance) {
-        for (int i = 0; i < 3; i++) sps[i] = *face.sps[i];
-    }
-
-    StackFace() = default;
-};
-
 #endif
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include "rigid.h"
+#include "mesh.h"
+#include <cstring>
+#include <iterator>
 
 Manifold::Manifold(Solver* solver, Rigid* bodyA, Rigid* bodyB) 
     : Force(solver, bodyA, bodyB), numContacts(0) 
@@ -10,21 +13,88 @@ Manifold::Manifold(Solver* solver, Rigid* bodyA, Rigid* bodyB)
     }
 }
 
+void Manifold::destroy() {
+    solver->manifoldPool.recycle(this);
+}
+
+Force* Manifold::clone(Solver* solver) const {
+    Manifold* copy = solver->manifoldPool.create(*this);
+    copy->solver = solver;
+    return copy;
+}
+
+#ifdef LINALG_VALIDATION
+// contacts hold checked vec6 rows, so they are written field by field
+static void writeFields(ByteWriter& out, const Manifold::Contact& contact) {
+    out.write(contact.JA, 3);
+    out.write(contact.JB, 3);
+    out.write(contact.C0);
+    out.write(contact.stick);
+}
+
+static bool readFields(ByteReader& in, Manifold::Contact& contact) {
+    return in.read(contact.JA, 3) && in.read(contact.JB, 3) && in.read(contact.C0) && in.read(contact.stick);
+}
+#endif
+
+void Manifold::save(ByteWriter& out) const {
+    out.write(numContacts);
+    out.write(friction);
+    out.write(contacts, 4);
+    out.write(points, 4);
+}
+
+// the contact count and the face vertex indices are used to index fixed size arrays, and stick
+// came in as a raw byte with the rest of the contact
+static bool validContacts(int count, const Manifold::Contact* contacts, const Manifold::ContactPoint* points) {
+    if (count < 0 || count > 4) return false;
+    for (int i = 0; i < 4; i++) {
+        uint8_t stick;
+        std::memcpy(&stick, &contacts[i].stick, 1);
+        if (stick > 1) return false;
+    }
+    for (int i = 0; i < count; i++)
+        for (int j = 0; j < 3; j++)
+            if (points[i].indexA[j] >= std::size(Mesh::uniqueVerts) || points[i].indexB[j] >= std::size(Mesh::uniqueVerts))
+                return false;
+    return true;
+}
+
+bool Manifold::check(ByteReader& in) const {
+    return checkState(in);
+}
+
+bool Manifold::checkState(ByteReader& in) {
+    int count = -1;
+    float mu = 0.0f;
+    Contact savedContacts[4];
+    ContactPoint savedPoints[4];
+    if (!in.read(count) || !in.read(mu) || !in.read(savedContacts, 4) || !in.read(savedPoints, 4)) return false;
+    return validContacts(count, savedContacts, savedPoints);
+}
+
+bool Manifold::load(ByteReader& in) {
+    int count = -1;
+    if (!in.read(count) || count < 0 || count > 4) return false;
+    numContacts = count;
+    if (in.read(friction) && in.read(contacts, 4) && in.read(points, 4) && validContacts(numContacts, contacts, points)) return true;
+    numContacts = 0;
+    return false;
+}
+
 bool Manifold::initialize() {
     // compute friction
     friction = sqrtf(bodyA->friction * bodyB->friction);
 
     // store previous contact state
     Contact oldContacts[4]; for (int i = 0; i < numContacts; i++) oldContacts[i] = contacts[i];
+    ContactPoint oldPoints[4]; for (int i = 0; i < numContacts; i++) oldPoints[i] = points[i];
     float oldPenalty[MAX_ROWS]; for (int i = 0; i < MAX_ROWS; i++) oldPenalty[i] = penalty[i];
     float oldLambda[MAX_ROWS];  for (int i = 0; i < MAX_ROWS; i++) oldLambda[i] = lambda[i];
-    bool oldStick[4]; for (int i = 0; i < numContacts; i++) oldStick[i] = contacts[i].stick;
-    int oldType[4]; for (int i = 0; i < numContacts; i++) oldType[i] = contacts[i].type;
     bool oldContactUsed[4]; for (int i = 0; i < numContacts; i++) oldContactUsed[i] = false;
 
     int oldNumContacts = numContacts;
     for (int i = 0; i < oldNumContacts; i++) {
-        oldContacts[i] = contacts[i];
         for (int k = 0; k < 3; k++) {
             oldPenalty[i * 3 + k] = penalty[i * 3 + k];
             oldLambda[i * 3 + k]  = lambda[i * 3 + k];
@@ -32,7 +102,7 @@ bool Manifold::initialize() {
     }
 
     // compute new contacts
-    numContacts = collide(bodyA, bodyB, contacts);
+    numContacts = collide(bodyA, bodyB, points);
     if (numContacts == 0) return false;
 
     // calculate 
@@ -49,15 +119,15 @@ bool Manifold::initialize() {
         // check if contact is still in the same place
         for (int i = 0; i < oldNumContacts; i++) {
             if (!canBeUsed[i]) continue;
-            const Contact& contact = oldContacts[i];
+            const ContactPoint& point = oldPoints[i];
 
             // ensure all minkowski difference support points are still in location
-            vec3 pOnA = transform(contact.rA, bodyA);
-            vec3 pOnB = transform(contact.rB, bodyB);
+            vec3 pOnA = transform(point.rA, bodyA);
+            vec3 pOnB = transform(point.rB, bodyB);
             vec3 sep = pOnA - pOnB;
             
             // determine if seperation is in direction of the current normal
-            if (glm::dot(contacts[0].normal, sep) > COLLISION_MARGIN ) {
+            if (glm::dot(points[0].normal, sep) > COLLISION_MARGIN ) {
                 canBeUsed[i] = false;
                 sumContacts--;
                 continue;
@@ -65,8 +135,8 @@ bool Manifold::initialize() {
 
             // check if minkowski points have drifted too much
             for (int j = 0; j < 3; j++) {
-                vec3 curMink = transform(contact.face.sps[j].indexB, bodyB) - transform(contact.face.sps[j].indexA, bodyA);
-                if (glm::length2(curMink - contact.face.sps[j].mink) > COLLISION_MARGIN) {
+                vec3 curMink = transform(point.indexB[j], bodyB) - transform(point.indexA[j], bodyA);
+                if (glm::length2(curMink - point.mink[j]) > COLLISION_MARGIN) {
                     canBeUsed[i] = false;
                     sumContacts--;
                     break;
@@ -78,10 +148,10 @@ bool Manifold::initialize() {
             // pick best old contact points to update
             // TODO find better selection algorithm
             vec3 tot = vec3();
-            for (int i = 0; i < numContacts; i++) tot += (contacts[i].rA + contacts[i].rB) / 2.0f;
+            for (int i = 0; i < numContacts; i++) tot += (points[i].rA + points[i].rB) / 2.0f;
 
             vec3 avgs[4];
-            for (int i = 0; i < oldNumContacts; i++) avgs[i] = (oldContacts[i].rA + oldContacts[i].rB) / 2.0f;
+            for (int i = 0; i < oldNumContacts; i++) avgs[i] = (oldPoints[i].rA + oldPoints[i].rB) / 2.0f;
 
             while (numContacts < 4 && sumContacts > 0) {
                 vec3 center = tot / (float) numContacts;
@@ -98,21 +168,14 @@ bool Manifold::initialize() {
                     }
                 }
 
-                // add best old point to new point
+                // add best old point to new point, keeping its friction state and body space points
                 canBeUsed[oldIndex] = false;
                 tot += avgs[oldIndex];
 
                 contacts[numContacts] = oldContacts[oldIndex];
+                points[numContacts] = oldPoints[oldIndex];
                 for (int k = 0; k < 3; k++) penalty[numContacts * 3 + k] = oldPenalty[oldIndex * 3 + k];
                 for (int k = 0; k < 3; k++) lambda[numContacts * 3 + k] = oldLambda[oldIndex * 3 + k];
-                contacts[numContacts].stick = oldStick[oldIndex];
-                contacts[numContacts].type = oldType[oldIndex];
-
-                // If static friction in last frame, use the old contact points
-                if (oldStick[oldIndex]) {
-                    contacts[numContacts].rA = oldContacts[oldIndex].rA;
-                    contacts[numContacts].rB = oldContacts[oldIndex].rB;
-                }
 
                 sumContacts--;
                 numContacts++;
@@ -124,50 +187,59 @@ bool Manifold::initialize() {
     // initialize contact data
     for (int i = 0; i < numContacts; i++) {
         Contact& contact = contacts[i];
+        const ContactPoint& point = points[i];
 
         // TODO check if scale needs to be added here
-        vec3 wA = rotateNScale(contact.rA, bodyA);
-        vec3 wB = rotateNScale(contact.rB, bodyB);
+        vec3 wA = rotateNScale(point.rA, bodyA);
+        vec3 wB = rotateNScale(point.rB, bodyB);
 
         // compute tangent data
-        vec3 linIndep = fabs(glm::dot(contact.normal, vec3(0, 1, 0))) > 0.95 ? vec3(1, 0, 0) : vec3(0, 1, 0);
-        contact.t1 = linIndep - glm::dot(linIndep, contact.normal) * contact.normal;
-        contact.t1 = glm::normalize(contact.t1);
-        contact.t2 = glm::normalize(glm::cross(contact.t1, contact.normal)); // guarunteed to be normal
+        vec3 normal = point.normal;
+        vec3 linIndep = fabs(glm::dot(normal, vec3(0, 1, 0))) > 0.95 ? vec3(1, 0, 0) : vec3(0, 1, 0);
+        vec3 t1 = glm::normalize(linIndep - glm::dot(linIndep, normal) * normal);
+        vec3 t2 = glm::normalize(glm::cross(t1, normal)); // guarunteed to be normal
 
         // compute derivatives using taylor series to the first degree
-        contact.JAn  = vec6(contact.normal, glm::cross(wA, contact.normal));
-        contact.JAt1 = vec6(contact.t1    , glm::cross(wA, contact.t1)    );
-        contact.JAt2 = vec6(contact.t2    , glm::cross(wA, contact.t2)    );
-
-        contact.JBn  = vec6(-1.0f * contact.normal, -1.0f * glm::cross(wB, contact.normal));
-        contact.JBt1 = vec6(-1.0f * contact.t1    , -1.0f * glm::cross(wB, contact.t1)    );
-        contact.JBt2 = vec6(-1.0f * contact.t2    , -1.0f * glm::cross(wB, contact.t2)    );
-
-        vec3 drX = bodyA->position + wA - bodyB->position - wB;
-        contact.C0.x = glm::dot(contact.normal, drX); // + COLLISION_MARGIN;
-        contact.C0.y = glm::dot(contact.t1,     drX);
-        contact.C0.z = glm::dot(contact.t2,     drX);
+        contact.JA[0] = vec6(normal, glm::cross(wA, normal));
+        contact.JA[1] = vec6(t1    , glm::cross(wA, t1)    );
+        contact.JA[2] = vec6(t2    , glm::cross(wA, t2)    );
+
+        contact.JB[0] = vec6(-1.0f * normal, -1.0f * glm::cross(wB, normal));
+        contact.JB[1] = vec6(-1.0f * t1    , -1.0f * glm::cross(wB, t1)    );
+        contact.JB[2] = vec6(-1.0f * t2    , -1.0f * glm::cross(wB, t2)    );
+
+        vec3 drX = vec3(bodyA->position + pvec3(wA) - bodyB->position - pvec3(wB));
+        contact.C0.x = glm::dot(normal, drX); // + COLLISION_MARGIN;
+        contact.C0.y = glm::dot(t1,     drX);
+        contact.C0.z = glm::dot(t2,     drX);
     }
 
     return true;
 }
 
 void Manifold::computeConstraint(float alpha) {
-    // compute positional changes
+    // compute positional changes, shared by all contacts
+    vec6 dpA = { bodyA->position - bodyA->initialPosition, bodyA->deltaWInitial() };
+    vec6 dpB = { bodyB->position - bodyB->initialPosition, bodyB->deltaWInitial() };
+
     for (int i = 0; i < numContacts; i++) {
         // --- Simple, Direct Constraint Calculation ---
         // Goal: C = 0 when objects are just touching, C < 0 when penetrating
         Contact& contact = contacts[i];
 
-        vec6 dpA = { bodyA->position - bodyA->initialPosition, bodyA->deltaWInitial() };
-        vec6 dpB = { bodyB->position - bodyB->initialPosition, bodyB->deltaWInitial() };
-
         // When C < 0, objects are too close (violating constraint)
         // When C >= 0, objects are properly separated (satisfying constraint)
-        C[i * 3 + 0] = contact.C0.x * (1 - alpha) + dot(contact.JAn,  dpA) + dot(contact.JBn,  dpB);
-        C[i * 3 + 1] = contact.C0.y * (1 - alpha) + dot(contact.JAt1, dpA) + dot(contact.JBt1, dpB);
-        C[i * 3 + 2] = contact.C0.z * (1 - alpha) + dot(contact.JAt2, dpA) + dot(contact.JBt2, dpB);
+        C[i * 3 + 0] = contact.C0.x * (1 - alpha) + dot(contact.JA[0], dpA) + dot(contact.JB[0], dpB);
+        C[i * 3 + 1] = contact.C0.y * (1 - alpha) + dot(contact.JA[1], dpA) + dot(contact.JB[1], dpB);
+        C[i * 3 + 2] = contact.C0.z * (1 - alpha) + dot(contact.JA[2], dpA) + dot(contact.JB[2], dpB);
+    }
+
+    computeLimits();
+}
+
+void Manifold::computeLimits() {
+    for (int i = 0; i < numContacts; i++) {
+        Contact& contact = contacts[i];
 
         // --- Update Force Limits for Friction Cone ---
         float frictionBound = abs(lambda[i * 3 + 0]) * friction;
@@ -181,34 +253,38 @@ void Manifold::computeConstraint(float alpha) {
     }
 }
 
-void Manifold::computeDerivatives(Rigid* body) {
+void Manifold::computeDerivatives(Rigid* body, vec6* J, vec6* H) {
     // Just store precomputed derivatives in J for the desired body
     for (int i = 0; i < numContacts; i++)
     {
-        Contact& contact = contacts[i];
-        
-        bool isA = body == bodyA;
+        const vec6* rows = body == bodyA ? contacts[i].JA : contacts[i].JB;
 
         // compute Jacobians
-        J[i * 3 + 0] = isA ? contact.JAn  : contact.JBn;
-        J[i * 3 + 1] = isA ? contact.JAt1 : contact.JBt1;
-        J[i * 3 + 2] = isA ? contact.JAt2 : contact.JBt2;
+        J[i * 3 + 0] = rows[0];
+        J[i * 3 + 1] = rows[1];
+        J[i * 3 + 2] = rows[2];
 
-        // compute Hessians
+        if (H == nullptr) continue;
+
+        // lumped hessians, the angular block of each row is 0.5 * (d s^T + s d^T) - (d . s) I
+        // only its column norms are needed, so the matrix is never formed
+        vec3 s = body == bodyA ? rotateNScale(points[i].rA, bodyA) : rotateNScale(points[i].rB, bodyB);
         for (int j = 0; j < 3; j++) {
-            vec3 dir = J[i * 3 + j].linear;
-            vec3 s = isA ? rotateNScale(contact.rA, bodyA) : rotateNScale(contact.rB, bodyB);
-            H[i * 3 + j] = mat6x6();
-            H[i * 3 + j].addBottomRight(lambda[i] * (0.5f * (outer(dir, s) + outer(s, dir) - glm::dot(dir, s) * glm::diagonal3x3(vec3(1.0f)))));
-
-            // H[i * 3 + j] = mat6x6();
-            // mat3x3 inertia = isA ? bodyA->getInertiaTensor() : bodyB->getInertiaTensor();
-            // H[i * 3 + j].addBottomRight(glm::diagonal3x3(glm::abs(glm::cross(J[i * 3 + j].angular, inertia * J[i * 3 + j].angular))));
+            vec3 dir = vec3(J[i * 3 + j].linear);
+            float ds = glm::dot(dir, s);
+
+            vec3 lump;
+            for (int c = 0; c < 3; c++) {
+                vec3 column = 0.5f * (dir * s[c] + s * dir[c]);
+                column[c] -= ds;
+                lump[c] = glm::length(column);
+            }
+            H[i * 3 + j] = vec6(vec3(0.0f), lump);
         }
     }
 }
 
-bool Manifold::isContactStillValid(const Contact& c, Rigid* A, Rigid* B)
+bool Manifold::isContactStillValid(const Contact& contact, const ContactPoint& c, Rigid* A, Rigid* B)
 {
     // Tolerances
     const float margin = COLLISION_MARGIN;
@@ -238,7 +314,7 @@ bool Manifold::isContactStillValid(const Contact& c, Rigid* A, Rigid* B)
     // --- 3) Optional: if we "stuck" the anchors, limit tangential slip ---
     // IMPORTANT: this assumes rA/rB are LOCAL anchors. If you sometimes store world-space,
     // either always store local or branch here to skip the transform for world-space anchors.
-    if (c.stick) {
+    if (contact.stick) {
         const vec3 pA = transform(c.rA, A); // xA + RA * rA_local
         const vec3 pB = transform(c.rB, B); // xB + RB * rB_local
 
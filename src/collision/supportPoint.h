@@ -33,4 +33,13 @@ struct SupportPointEqual {
 
 using Edge = std::pair<const SupportPoint*, const SupportPoint*>;
 
+// orders edges by support point indices rather than by address, so EPA is reproducible
+struct EdgeCompare {
+    bool operator()(const Edge& a, const Edge& b) const {
+        if (*a.first < *b.first) return true;
+        if (*b.first < *a.first) return false;
+        return *a.second < *b.second;
+    }
+};
+
 #endif
\ No newline at end of file
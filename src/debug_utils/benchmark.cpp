@@ -0,0 +1,289 @@
+#include "benchmark.h"
+#include "linalg/batch.h"
+#include "linalg/ldlt.h"
+#include "linalg/linalg.h"
+#include "solver.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+// mean wall time of f(i) over i in [0, repeats), in units of Duration
+template <typename Duration, typename F>
+static double meanTime(int repeats, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) f(i);
+    return std::chrono::duration<double, typename Duration::period>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+// ground plus side x side columns of height unit boxes
+struct GridScene {
+    int side = 1;
+    int height = 1;
+    float spacing = 1.0f; // between neighbouring columns
+    float rise = 0.5f; // between boxes in a column, below 0.5 starts them overlapping
+    float base = -0.5f; // height of the lowest box
+    float jitter = 0.0f; // random sideways offset of each box
+    bool shuffle = false; // create boxes in random order, so neither the body array nor the heap follows their position
+};
+
+static void buildGrid(Solver& solver, const GridScene& scene) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> jitter(-scene.jitter, scene.jitter);
+
+    float offset = (scene.side - 1) * scene.spacing * 0.5f;
+    std::vector<vec3> positions;
+    for (int x = 0; x < scene.side; x++)
+        for (int z = 0; z < scene.side; z++)
+            for (int i = 0; i < scene.height; i++)
+                positions.push_back(vec3(x * scene.spacing - offset + jitter(rng), i * scene.rise + scene.base, z * scene.spacing - offset + jitter(rng)));
+    if (scene.shuffle) std::shuffle(positions.begin(), positions.end(), rng);
+
+    float ground = std::max(15.0f, offset + 4.0f);
+    new Rigid(&solver, {ground, 0.25f, ground}, -1.0f, 0.5f, {0, -1.0f, 0});
+    for (const vec3& position : positions)
+        new Rigid(&solver, vec3(0.5f), 10.0f, 0.4f, position);
+}
+
+// builds systems shaped like the primal update, M / dt^2 + sum(J^T * penalty * J)
+static void buildSystems(std::vector<mat6x6>& lhs, std::vector<vec6>& rhs, int samples) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> size(0.5f, 1.5f);
+    std::uniform_real_distribution<float> logPenalty(3.0f, 6.0f);
+
+    const float dt = 1.0f / 60.0f;
+    lhs.resize(samples);
+    rhs.resize(samples);
+
+    for (int s = 0; s < samples; s++) {
+        vec3 scale = { size(rng), size(rng), size(rng) };
+        float mass = scale.x * scale.y * scale.z * 10.0f;
+        mat3x3 inertia = glm::diagonal3x3(vec3(
+            mass * (scale.y * scale.y + scale.z * scale.z),
+            mass * (scale.x * scale.x + scale.z * scale.z),
+            mass * (scale.x * scale.x + scale.y * scale.y)
+        ) / 12.0f);
+        mat3x3 R = mat3x3(glm::normalize(quat(unit(rng), unit(rng), unit(rng), unit(rng))));
+
+        lhs[s] = mat6x6(mass * mat3x3(1.0f), mat3x3(), mat3x3(), R * inertia * glm::transpose(R)) / (dt * dt);
+        rhs[s] = vec6(unit(rng), unit(rng), unit(rng), unit(rng), unit(rng), unit(rng));
+
+        // up to 4 contacts with a normal and two tangent rows each
+        int rows = 3 * (1 + rng() % 4);
+        for (int i = 0; i < rows; i++) {
+            vec3 dir = glm::normalize(vec3(unit(rng), unit(rng), unit(rng)));
+            vec3 r = vec3(unit(rng), unit(rng), unit(rng)) * scale * 0.5f;
+            vec6 J = vec6(dir, glm::cross(r, dir));
+            lhs[s] += outer(J, J * powf(10.0f, logPenalty(rng)));
+        }
+    }
+}
+
+// relative difference of a solution from the reference solution
+static float relativeError(const vec6& x, const vec6& reference) {
+    vec6 diff = x - reference;
+    solveScalar norm = glm::max(dot(reference, reference), (solveScalar) 1e-30f);
+    return (float) std::sqrt(dot(diff, diff) / norm);
+}
+
+bool benchmarkSolve(int samples, float tolerance) {
+    std::vector<mat6x6> lhs;
+    std::vector<vec6> rhs;
+    buildSystems(lhs, rhs, samples);
+
+    std::vector<vec6> reference(samples), block(samples), batched(samples);
+
+    double ldltTime = meanTime<std::chrono::nanoseconds>(samples, [&](int s) { reference[s] = solve(lhs[s], rhs[s]); });
+    double blockTime = meanTime<std::chrono::nanoseconds>(samples, [&](int s) { block[s] = solveBlock(lhs[s], rhs[s]); });
+
+    // SIMD_LANES systems per batch, the last batch holds whatever is left over
+    SystemBatch batch;
+    int batches = (samples + SIMD_LANES - 1) / SIMD_LANES;
+    double batchTime = meanTime<std::chrono::nanoseconds>(batches, [&](int b) {
+        int first = b * SIMD_LANES;
+        int count = std::min(SIMD_LANES, samples - first);
+        batch.clear();
+        for (int l = 0; l < count; l++) batch.add(lhs[first + l], rhs[first + l]);
+        solve(batch);
+        for (int l = 0; l < count; l++) batched[first + l] = batch.solution(l);
+    }) * batches / glm::max(samples, 1);
+
+    float worstBlock = 0.0f, worstBatch = 0.0f;
+    for (int s = 0; s < samples; s++) {
+        worstBlock = glm::max(worstBlock, relativeError(block[s], reference[s]));
+        worstBatch = glm::max(worstBatch, relativeError(batched[s], reference[s]));
+    }
+
+    // every partly filled batch size, reusing the batch so the unused lanes still hold the last full batch
+    for (int count = 1; count < SIMD_LANES && count <= samples; count++) {
+        batch.clear();
+        for (int s = 0; s < SIMD_LANES && s < samples; s++) batch.add(lhs[s], rhs[s]);
+        batch.clear();
+        for (int s = 0; s < count; s++) batch.add(lhs[s], rhs[s]);
+        solve(batch);
+        for (int s = 0; s < count; s++) worstBatch = glm::max(worstBatch, relativeError(batch.solution(s), reference[s]));
+    }
+
+    std::cout << "solve:      " << ldltTime << " ns" << std::endl;
+    std::cout << "solveBlock: " << blockTime << " ns" << std::endl;
+    std::cout << "batch:      " << batchTime << " ns per system, " << SIMD_LANES << " lanes" << std::endl;
+    std::cout << "max relative difference: " << worstBlock << " block, " << worstBatch << " batch" << std::endl;
+
+    return worstBlock <= tolerance && worstBatch <= tolerance;
+}
+
+
+// single tower of boxes resting on the ground
+static void buildStack(Solver& solver) {
+    GridScene scene;
+    scene.height = 8;
+    buildGrid(solver, scene);
+}
+
+// randomly sized and rotated boxes dropped onto each other
+static void buildPile(Solver& solver) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(-0.5f, 0.5f);
+    std::uniform_real_distribution<float> size(0.5f, 1.5f);
+
+    new Rigid(&solver, {15, 0.25f, 15}, -1.0f, 0.5f, {0, -1.0f, 0});
+    for (int i = 0; i < 20; i++)
+        new Rigid(&solver, vec3(size(rng), size(rng), size(rng)), 10.0f, 0.4f, vec3(unit(rng), i * 0.5f + unit(rng), unit(rng)),
+                  quat(1.0f + unit(rng), unit(rng), unit(rng), unit(rng)));
+}
+
+// mean of the largest active constraint error over every step
+static float convergenceError(void (*build)(Solver&), int iterations, bool accelerate, int steps) {
+    Solver solver;
+    solver.gravity = vec3(0, -9.8f, 0);
+    solver.iterations = iterations;
+    solver.accelerate = accelerate;
+    solver.allowSleep = false;
+    build(solver);
+
+    float error = 0.0f;
+    for (int i = 0; i < steps; i++) {
+        solver.step(1.0f / 60.0f);
+        error += solver.stepDualResidual;
+    }
+    return error / steps;
+}
+
+void benchmarkConvergence(int maxIterations, int steps) {
+    const char* names[] = { "stack", "pile" };
+    void (*builds[])(Solver&) = { buildStack, buildPile };
+
+    for (int scene = 0; scene < 2; scene++) {
+        std::cout << names[scene] << std::endl;
+        std::cout << "iterations\tplain\t\tchebyshev" << std::endl;
+        for (int it = 1; it <= maxIterations; it++) {
+            float plain = convergenceError(builds[scene], it, false, steps);
+            float accelerated = convergenceError(builds[scene], it, true, steps);
+            std::cout << it << "\t\t" << plain << "\t" << accelerated << std::endl;
+        }
+    }
+}
+
+// side x side columns of loosely stacked boxes created in shuffled order, timed after settling so the
+// contact set is stable
+static double timeWidePile(int side, int height, int steps, int reorderInterval) {
+    Solver solver;
+    solver.gravity = vec3(0, -9.8f, 0);
+    solver.allowSleep = false;
+    solver.reorderInterval = reorderInterval;
+
+    GridScene scene;
+    scene.side = side;
+    scene.height = height;
+    scene.spacing = 0.55f;
+    scene.rise = 0.55f;
+    scene.jitter = 0.05f;
+    scene.shuffle = true;
+    buildGrid(solver, scene);
+
+    for (int i = 0; i < 30; i++) solver.step(1.0f / 60.0f);
+    return meanTime<std::chrono::milliseconds>(steps, [&](int) { solver.step(1.0f / 60.0f); });
+}
+
+void benchmarkReorder(int side, int height, int steps) {
+    std::cout << side * side * height << " bodies" << std::endl;
+    std::cout << "interval\tms per step" << std::endl;
+    for (int interval : { 0, 1, 30 })
+        std::cout << interval << "\t\t" << timeWidePile(side, height, steps, interval) << std::endl;
+}
+
+static int sleepingBodies(const Solver& solver) {
+    int count = 0;
+    for (const Rigid* body : solver.bodies) count += body->sleeping;
+    return count;
+}
+
+// saves while a stack sleeps and a box is still falling onto it, then checks that a restore brings
+// back the sleeping stack and replays the landing that wakes it
+static bool snapshotWhileAsleep() {
+    Solver solver;
+    solver.gravity = vec3(0, -9.8f, 0);
+
+    GridScene scene;
+    scene.height = 3;
+    buildGrid(solver, scene);
+    new Rigid(&solver, vec3(0.5f), 10.0f, 0.4f, vec3(0.0f, 25.0f, 0.0f));
+
+    int steps = 0;
+    while (sleepingBodies(solver) == 0 && steps++ < 300) solver.step(1.0f / 60.0f);
+    int asleep = sleepingBodies(solver);
+
+    std::vector<uint8_t> buffer;
+    solver.saveSnapshot(buffer);
+
+    // until the box has landed and woken the stack
+    steps = 0;
+    while (sleepingBodies(solver) > 0 && steps < 300) {
+        solver.step(1.0f / 60.0f);
+        steps++;
+    }
+    for (int i = 0; i < 10; i++, steps++) solver.step(1.0f / 60.0f);
+    uint64_t expected = solver.hashState();
+
+    bool restored = solver.loadSnapshot(buffer.data(), buffer.size());
+    bool stillAsleep = asleep > 0 && sleepingBodies(solver) == asleep;
+    for (int i = 0; i < steps; i++) solver.step(1.0f / 60.0f);
+    return restored && stillAsleep && solver.hashState() == expected;
+}
+
+bool benchmarkSnapshot(int bodies, int repeats) {
+    const int height = 5;
+    int side = std::max(1, (int) std::sqrt(bodies / (float) height));
+
+    Solver solver;
+    solver.gravity = vec3(0, -9.8f, 0);
+    solver.allowSleep = false;
+
+    // slightly overlapping so every stack starts with contacts
+    GridScene scene;
+    scene.side = side;
+    scene.height = height;
+    scene.spacing = 1.2f;
+    scene.rise = 0.49f;
+    scene.base = -0.63f;
+    buildGrid(solver, scene);
+    for (int i = 0; i < 10; i++) solver.step(1.0f / 60.0f);
+
+    std::vector<uint8_t> buffer;
+    double save = meanTime<std::chrono::microseconds>(repeats, [&](int) { solver.saveSnapshot(buffer); });
+    double load = meanTime<std::chrono::microseconds>(repeats, [&](int) { solver.loadSnapshot(buffer.data(), buffer.size()); });
+
+    // the same steps from the same snapshot, contacts change in between so some are recreated
+    for (int i = 0; i < 3; i++) solver.step(1.0f / 60.0f);
+    uint64_t expected = solver.hashState();
+    bool restored = solver.loadSnapshot(buffer.data(), buffer.size());
+    for (int i = 0; i < 3; i++) solver.step(1.0f / 60.0f);
+    bool identical = restored && solver.hashState() == expected;
+
+    std::cout << solver.bodies.size() << " bodies, " << solver.forces.size() << " forces, " << buffer.size() / 1024 << " KB" << std::endl;
+    std::cout << "save " << save << " us, restore " << load << " us, identical " << (identical ? "yes" : "no") << std::endl;
+
+    bool sleeping = snapshotWhileAsleep();
+    std::cout << "restore while asleep, identical " << (sleeping ? "yes" : "no") << std::endl;
+    return identical && sleeping;
+}
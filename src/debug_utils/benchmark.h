@@ -0,0 +1,21 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "util/includes.h"
+
+// times solveBlock and the SIMD batch solve against the reference LDL^T solve on random contact systems,
+// returns false if any solution differs by more than the relative tolerance
+bool benchmarkSolve(int samples, float tolerance = 1e-3f);
+
+// prints the mean constraint error against the iteration count for a stack and a pile,
+// with and without Chebyshev acceleration
+void benchmarkConvergence(int maxIterations, int steps = 120);
+
+// times steps of a wide pile created in random order, with and without Morton reordering
+void benchmarkReorder(int side, int height, int steps = 300);
+
+// times saveSnapshot and loadSnapshot on a settled grid of stacks, returns false if the steps
+// after a restore differ from the steps after the save, there or on a sleeping stack
+bool benchmarkSnapshot(int bodies, int repeats = 100);
+
+#endif
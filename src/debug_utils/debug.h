@@ -7,4 +7,19 @@ inline bool hasNaN(const vec3& v) {
     return std::isnan(v.x) || std::isnan(v.y) || std::isnan(v.z);
 }
 
-#endif
\ No newline at end of file
+inline bool hasNaN(const glm::dvec3& v) {
+    return std::isnan(v.x) || std::isnan(v.y) || std::isnan(v.z);
+}
+
+inline bool hasNaN(const quat& q) {
+    return std::isnan(q.x) || std::isnan(q.y) || std::isnan(q.z) || std::isnan(q.w);
+}
+
+// per operation linalg checks, compiled out unless LINALG_VALIDATION is defined
+#ifdef LINALG_VALIDATION
+#define LINALG_ASSERT(cond, msg) do { if (!(cond)) throw std::runtime_error(msg); } while (0)
+#else
+#define LINALG_ASSERT(cond, msg) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,50 @@
+#include "solver.h"
+#include <algorithm>
+
+// puts the body array back in creation order
+void Solver::sortBodies() {
+    std::sort(bodies.begin(), bodies.end(), [](const Rigid* a, const Rigid* b) { return a->id < b->id; });
+    for (int i = 0; i < (int) bodies.size(); i++) bodies[i]->index = i;
+}
+
+// puts the force array and the force chain of every body back in creation order, the step's
+// adjacency follows the force array and decides the accumulation order of every primal system
+void Solver::sortForces() {
+    std::sort(forces.begin(), forces.end(), [](const Force* a, const Force* b) { return a->id < b->id; });
+    for (int i = 0; i < (int) forces.size(); i++) forces[i]->index = i;
+
+    for (Rigid* body : bodies) body->forces = nullptr;
+
+    for (auto it = forces.rbegin(); it != forces.rend(); it++) {
+        Force* force = *it;
+
+        if (force->bodyA) {
+            force->nextA = force->bodyA->forces;
+            force->bodyA->forces = force;
+        }
+        if (force->bodyB) {
+            force->nextB = force->bodyB->forces;
+            force->bodyB->forces = force;
+        }
+    }
+}
+
+// 64-bit FNV-1a over the exact bits of every body's id, pose and velocity in array order
+uint64_t Solver::hashState() const {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = (const unsigned char*) data;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    for (Rigid* body : bodies) {
+        mix(&body->id, sizeof(body->id));
+        mix(&body->position, sizeof(body->position));
+        mix(&body->rotation, sizeof(body->rotation));
+        mix(&body->velocity, sizeof(body->velocity));
+    }
+    return hash;
+}
@@ -1,9 +1,12 @@
 #include "solver.h"
 
-Force::Force(Solver* solver, Rigid* bodyA, Rigid* bodyB) : solver(solver), bodyA(bodyA), bodyB(bodyB), nextA(nullptr), nextB(nullptr) {
-    // add force to linked list
-    next = solver->forces;
-    solver->forces = this;
+Force::Force(Solver* solver, Rigid* bodyA, Rigid* bodyB) : solver(solver), bodyA(bodyA), bodyB(bodyB), nextA(nullptr), nextB(nullptr), inIsland(false) {
+    id = solver->nextForceId++;
+
+    // add force to the dense force array
+    index = (int) solver->forces.size();
+    solver->forces.push_back(this);
+    handle = solver->forceHandles.insert(this);
 
     if (bodyA) {
         nextA = bodyA->forces;
@@ -15,15 +18,8 @@ Force::Force(Solver* solver, Rigid* bodyA, Rigid* bodyB) : solver(solver), bodyA
         bodyB->forces = this;
     }
 
-    // allocate memory for vectors
-    J.resize(MAX_ROWS);
-    H.resize(MAX_ROWS);
-
     // set reasonable defaults
     for (int i = 0; i < MAX_ROWS; i++) {
-        J[i] = vec6(0); // 6 DOF
-        H[i] = mat6x6(); // error here
-
         C[i] = 0.0f;
         motor[i] = 0.0f;
 
@@ -38,11 +34,15 @@ Force::Force(Solver* solver, Rigid* bodyA, Rigid* bodyB) : solver(solver), bodyA
 }
 
 Force::~Force() {
-    // remove from all linked lists
-    Force** p = &solver->forces;
-    while (*p != this) p = &(*p)->next;
-    *p = next;
+    // swap remove from the dense force array
+    Force* last = solver->forces.back();
+    solver->forces[index] = last;
+    last->index = index;
+    solver->forces.pop_back();
+    solver->forceHandles.erase(handle);
 
+    // remove from the force chains of both bodies
+    Force** p;
     if (bodyA)
     {
         p = &bodyA->forces;
@@ -58,6 +58,15 @@ Force::~Force() {
             p = (*p)->bodyA == bodyB ? &(*p)->nextA : &(*p)->nextB;
         *p = nextB;
     }
+
+    solver->leaveIsland(this);
+
+    // removing a force can split an island or take away a support
+    if (inIsland) {
+        solver->islandsDirty = true;
+        solver->wakeIsland(bodyA);
+        solver->wakeIsland(bodyB);
+    }
 }
 
 void Force::disable() {
@@ -66,4 +75,9 @@ void Force::disable() {
         penalty[i] = 0.0f;
         lambda[i] = 0.0f;
     }
+}
+
+// forces are only solved while at least one of their bodies is awake
+bool Force::active() const {
+    return (bodyA && bodyA->awake()) || (bodyB && bodyB->awake());
 }
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "solver.h"
+#include <algorithm>
+
+// union-find root with path halving
+Rigid* Rigid::islandRoot() {
+    Rigid* root = this;
+    while (root->islandParent != root) {
+        root->islandParent = root->islandParent->islandParent;
+        root = root->islandParent;
+    }
+    return root;
+}
+
+// counting sort of the force array by body, so each body lists its forces in force array order
+void Solver::buildAdjacency() {
+    int count = (int) bodies.size();
+    adjacencyStart.assign(count + 1, 0);
+    for (Force* force : forces) {
+        if (force->bodyA) adjacencyStart[force->bodyA->index + 1]++;
+        if (force->bodyB) adjacencyStart[force->bodyB->index + 1]++;
+    }
+    for (int i = 0; i < count; i++) adjacencyStart[i + 1] += adjacencyStart[i];
+
+    // fill using each start as a cursor, which leaves it at the start of the next body
+    adjacency.resize(adjacencyStart[count]);
+    for (Force* force : forces) {
+        if (force->bodyA) adjacency[adjacencyStart[force->bodyA->index]++] = force;
+        if (force->bodyB) adjacency[adjacencyStart[force->bodyB->index]++] = force;
+    }
+    for (int i = count; i > 0; i--) adjacencyStart[i] = adjacencyStart[i - 1];
+    adjacencyStart[0] = 0;
+}
+
+// true if any force on the body connects it to one of the others, uses the adjacency of the current step
+bool Solver::connected(const Rigid* body, Rigid* const* others, int count) const {
+    for (int k = adjacencyStart[body->index]; k < adjacencyStart[body->index + 1]; k++) {
+        const Force* force = adjacency[k];
+        Rigid* other = force->bodyA == body ? force->bodyB : force->bodyA;
+        for (int i = 0; i < count; i++) if (others[i] == other) return true;
+    }
+    return false;
+}
+
+// joins the islands of both bodies of a force, static bodies never join an island
+void Solver::mergeIslands(Force* force) {
+    force->inIsland = true;
+    if (force->bodyA == nullptr || force->bodyB == nullptr) return;
+    if (force->bodyA->mass <= 0 || force->bodyB->mass <= 0) return;
+
+    Rigid* a = force->bodyA->islandRoot();
+    Rigid* b = force->bodyB->islandRoot();
+    if (a == b) return;
+
+    // union by rank
+    if (a->islandRank < b->islandRank) std::swap(a, b);
+    b->islandParent = a;
+    if (a->islandRank == b->islandRank) a->islandRank++;
+}
+
+// groups dynamic bodies and their forces by union-find root, only rebuilding the union-find after removals
+void Solver::buildIslands() {
+    if (islandsDirty) {
+        for (Rigid* body : bodies) {
+            body->islandParent = body;
+            body->islandRank = 0;
+        }
+        for (Force* force : forces) mergeIslands(force);
+        islandsDirty = false;
+    }
+
+    // island storage is reused between steps
+    for (Island& island : islands) {
+        island.bodies.clear();
+        island.forces.clear();
+    }
+
+    int count = 0;
+    for (Rigid* body : bodies) body->island = -1;
+    for (Rigid* body : bodies) {
+        if (body->mass <= 0) continue;
+
+        Rigid* root = body->islandRoot();
+        if (root->island < 0) {
+            root->island = count++;
+            if ((int) islands.size() < count) islands.emplace_back();
+        }
+        body->island = root->island;
+        islands[body->island].bodies.push_back(body);
+    }
+    islands.resize(count);
+
+    // forces belong to the island of their dynamic body, forces between static bodies are never solved
+    for (Force* force : forces) {
+        Rigid* body = force->bodyA && force->bodyA->mass > 0 ? force->bodyA : force->bodyB;
+        if (body == nullptr || body->mass <= 0) continue;
+        islands[body->island].forces.push_back(force);
+    }
+
+    // largest islands first so the small ones fill in around them on the thread pool
+    std::stable_sort(islands.begin(), islands.end(), [](const Island& a, const Island& b) {
+        return a.bodies.size() > b.bodies.size();
+    });
+
+    for (int i = 0; i < (int) islands.size(); i++) {
+        Island& island = islands[i];
+
+        // an island sleeps only if all of its bodies do, anything else wakes it
+        island.sleeping = true;
+        for (Rigid* body : island.bodies) {
+            body->island = i;
+            island.sleeping &= body->sleeping;
+        }
+        if (!island.sleeping) for (Rigid* body : island.bodies) body->sleeping = false;
+    }
+}
+
+// wakes every body in the island of a sleeping body, uses the islands from the last buildIslands
+void Solver::wakeIsland(Rigid* body) {
+    if (body == nullptr || !body->sleeping) return;
+
+    if (body->island >= 0 && body->island < (int) islands.size()) {
+        Island& island = islands[body->island];
+        island.sleeping = false;
+        for (Rigid* other : island.bodies) {
+            other->sleeping = false;
+            other->sleepTimer = 0.0f;
+        }
+    }
+
+    body->sleeping = false;
+    body->sleepTimer = 0.0f;
+}
+
+// drops a body that is being destroyed from the islands of the last step, which are read by
+// wakeIsland, clone, snapshots and reorderBodies until the next step rebuilds them
+void Solver::leaveIsland(Rigid* body) {
+    if (body->island < 0 || body->island >= (int) islands.size()) return;
+    std::vector<Rigid*>& list = islands[body->island].bodies;
+    list.erase(std::remove(list.begin(), list.end(), body), list.end());
+}
+
+// forces are listed in the island of their dynamic body, see buildIslands
+void Solver::leaveIsland(Force* force) {
+    Rigid* body = force->bodyA && force->bodyA->mass > 0 ? force->bodyA : force->bodyB;
+    if (body == nullptr || body->island < 0 || body->island >= (int) islands.size()) return;
+    std::vector<Force*>& list = islands[body->island].forces;
+    list.erase(std::remove(list.begin(), list.end(), force), list.end());
+}
+
+// puts islands to sleep once every body has been slow for sleepTime
+void Solver::updateSleep(float dt) {
+    float linear2 = sleepLinearVelocity * sleepLinearVelocity;
+    float angular2 = sleepAngularVelocity * sleepAngularVelocity;
+
+    for (Island& island : islands) {
+        if (island.sleeping) continue;
+
+        float minTimer = INFINITY;
+        for (Rigid* body : island.bodies) {
+            bool resting = glm::length2(body->velocity.linear) < linear2 && glm::length2(body->velocity.angular) < angular2;
+            body->sleepTimer = resting ? body->sleepTimer + dt : 0.0f;
+            minTimer = glm::min(minTimer, body->sleepTimer);
+        }
+
+        if (minTimer < sleepTime) continue;
+
+        // freeze the island, its forces keep their warmstart state until it wakes
+        island.sleeping = true;
+        for (Rigid* body : island.bodies) {
+            body->sleeping = true;
+            body->velocity = vec6(0);
+            body->prevVelocity = vec6(0);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#include "batch.h"
+
+// index into a row major lower triangle
+static inline int tri(int r, int c) { return r * (r + 1) / 2 + c; }
+
+void SystemBatch::add(const mat6x6& mat, const vec6& vec) {
+    if (size == SIMD_LANES) throw std::runtime_error("SystemBatch: batch is full.");
+
+    for (int r = 0; r < 6; r++) {
+        const vec6& row = mat.rows[r];
+        for (int c = 0; c <= r; c++) lhs[tri(r, c)][size] = c < 3 ? row.linear[c] : row.angular[c - 3];
+        rhs[r][size] = r < 3 ? vec.linear[r] : vec.angular[r - 3];
+    }
+    size++;
+}
+
+vec6 SystemBatch::solution(int lane) const {
+    return { svec3(x[0][lane], x[1][lane], x[2][lane]), svec3(x[3][lane], x[4][lane], x[5][lane]) };
+}
+
+// symmetric 3x3 inverse from cofactors, in and out are lower triangles (00, 10, 11, 20, 21, 22)
+static inline void inverseSymmetric(const floatN* m, floatN* inv) {
+    floatN a = m[0], b = m[1], d = m[2], c = m[3], e = m[4], f = m[5];
+
+    floatN c00 = d * f - e * e;
+    floatN c01 = c * e - b * f;
+    floatN c02 = b * e - c * d;
+    floatN c11 = a * f - c * c;
+    floatN c12 = b * c - a * e;
+    floatN c22 = a * d - b * b;
+
+    floatN invDet = floatN(1.0f) / (a * c00 + b * c01 + c * c02);
+
+    inv[0] = c00 * invDet;
+    inv[1] = c01 * invDet;
+    inv[2] = c11 * invDet;
+    inv[3] = c02 * invDet;
+    inv[4] = c12 * invDet;
+    inv[5] = c22 * invDet;
+}
+
+// solves every lane with the same 3x3 block Schur complement as solveBlock, unused lanes are padded with identity
+void solve(SystemBatch& batch) {
+    for (int l = batch.size; l < SIMD_LANES; l++) {
+        for (int r = 0; r < 6; r++) {
+            for (int c = 0; c <= r; c++) batch.lhs[tri(r, c)][l] = r == c ? 1.0f : 0.0f;
+            batch.rhs[r][l] = 0.0f;
+        }
+    }
+
+    // load blocks [A B; B^T C]
+    floatN A[6], C[6], Bt[3][3];
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c <= r; c++) {
+            A[tri(r, c)] = floatN::load(batch.lhs[tri(r, c)]);
+            C[tri(r, c)] = floatN::load(batch.lhs[tri(r + 3, c + 3)]);
+        }
+        for (int c = 0; c < 3; c++) Bt[r][c] = floatN::load(batch.lhs[tri(r + 3, c)]);
+    }
+
+    floatN b1[3], b2[3];
+    for (int i = 0; i < 3; i++) {
+        b1[i] = floatN::load(batch.rhs[i]);
+        b2[i] = floatN::load(batch.rhs[i + 3]);
+    }
+
+    floatN Ainv[6];
+    inverseSymmetric(A, Ainv);
+
+    // full row access into the symmetric inverse
+    auto ainv = [&](int r, int c) { return r >= c ? Ainv[tri(r, c)] : Ainv[tri(c, r)]; };
+
+    // A^-1 B
+    floatN AinvB[3][3];
+    for (int r = 0; r < 3; r++)
+        for (int c = 0; c < 3; c++)
+            AinvB[r][c] = ainv(r, 0) * Bt[c][0] + ainv(r, 1) * Bt[c][1] + ainv(r, 2) * Bt[c][2];
+
+    // S = C - B^T A^-1 B
+    floatN S[6], Sinv[6];
+    for (int r = 0; r < 3; r++)
+        for (int c = 0; c <= r; c++)
+            S[tri(r, c)] = C[tri(r, c)] - (Bt[r][0] * AinvB[0][c] + Bt[r][1] * AinvB[1][c] + Bt[r][2] * AinvB[2][c]);
+    inverseSymmetric(S, Sinv);
+
+    auto sinv = [&](int r, int c) { return r >= c ? Sinv[tri(r, c)] : Sinv[tri(c, r)]; };
+
+    floatN y[3], t[3];
+    for (int r = 0; r < 3; r++) y[r] = ainv(r, 0) * b1[0] + ainv(r, 1) * b1[1] + ainv(r, 2) * b1[2];
+    for (int r = 0; r < 3; r++) t[r] = b2[r] - (Bt[r][0] * y[0] + Bt[r][1] * y[1] + Bt[r][2] * y[2]);
+
+    floatN angular[3];
+    for (int r = 0; r < 3; r++) angular[r] = sinv(r, 0) * t[0] + sinv(r, 1) * t[1] + sinv(r, 2) * t[2];
+
+    for (int r = 0; r < 3; r++) {
+        floatN linear = y[r] - (AinvB[r][0] * angular[0] + AinvB[r][1] * angular[1] + AinvB[r][2] * angular[2]);
+        linear.store(batch.x[r]);
+        angular[r].store(batch.x[r + 3]);
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "simd.h"
+#include "mat6x6.h"
+
+// SIMD_LANES independent 6x6 SPD systems stored lane-wise (AoSoA), lane l of every entry belongs to system l
+struct SystemBatch {
+    alignas(SIMD_ALIGN) solveScalar lhs[21][SIMD_LANES]; // lower triangle, row major
+    alignas(SIMD_ALIGN) solveScalar rhs[6][SIMD_LANES];
+    alignas(SIMD_ALIGN) solveScalar x[6][SIMD_LANES];
+    int size = 0;
+
+    void add(const mat6x6& lhs, const vec6& rhs);
+    vec6 solution(int lane) const;
+    void clear() { size = 0; }
+};
+
+void solve(SystemBatch& batch);
+
+#endif
@@ -12,7 +12,7 @@ vec6 solve(const mat6x6& lhs, const vec6& rhs) {
     // compute LDL^T decomposition
     for (int i = 0; i < 6; i++) {
         // compute D[i]
-        float sum = 0.0f;
+        solveScalar sum = 0.0f;
         for (int j = 0; j < i; j++) sum += L[i][j] * L[i][j] * D[j];
         D[i] = lhs[i][i] - sum;
 
@@ -20,7 +20,7 @@ vec6 solve(const mat6x6& lhs, const vec6& rhs) {
 
         // compute L[j][i] for j > i
         for (int j = i + 1; j < 6; j++) {
-            float s = lhs[j][i];
+            solveScalar s = lhs[j][i];
             for (int k = 0; k < i; k++) s -= L[j][k] * L[i][k] * D[k];
             L[j][i] = s / D[i];
         }
@@ -35,7 +35,7 @@ vec6 solve(const mat6x6& lhs, const vec6& rhs) {
     // forward substitution: solve Ly = b
     vec6 y = vec6();
     for (int i = 0; i < 6; i++) {
-        float sum = 0.0f;
+        solveScalar sum = 0.0f;
         for (int j = 0; j < i; j++) sum += L[i][j] * y[j];
         y[i] = rhs[i] - sum;
     }
@@ -53,7 +53,7 @@ vec6 solve(const mat6x6& lhs, const vec6& rhs) {
     // backward substitution: solve L^T x = z
     vec6 x = vec6();
     for (int i = 5; i >= 0; i--) {
-        float sum = 0.0f;
+        solveScalar sum = 0.0f;
         for (int j = i + 1; j < 6; j++) sum += L[j][i] * x[j];
         x[i] = z[i] - sum;
     }
@@ -62,4 +62,46 @@ vec6 solve(const mat6x6& lhs, const vec6& rhs) {
     if (DEBUG_LINEAR_PRINT) print(x);
 
     return x;
+}
+
+// inverse of a symmetric 3x3 matrix from its six unique cofactors
+smat3x3 inverseSymmetric(const smat3x3& mat) {
+    solveScalar a = mat[0][0], b = mat[1][0], c = mat[2][0];
+    solveScalar d = mat[1][1], e = mat[2][1];
+    solveScalar f = mat[2][2];
+
+    solveScalar c00 = d * f - e * e;
+    solveScalar c01 = c * e - b * f;
+    solveScalar c02 = b * e - c * d;
+    solveScalar c11 = a * f - c * c;
+    solveScalar c12 = b * c - a * e;
+    solveScalar c22 = a * d - b * b;
+
+    solveScalar invDet = 1.0f / (a * c00 + b * c01 + c * c02);
+
+    return smat3x3(
+        svec3(c00, c01, c02) * invDet,
+        svec3(c01, c11, c12) * invDet,
+        svec3(c02, c12, c22) * invDet
+    );
+}
+
+// solves the SPD system using its 3x3 blocks [A B; B^T C] and the Schur complement of A
+vec6 solveBlock(const mat6x6& lhs, const vec6& rhs) {
+    // glm is column major, so loading rows as columns gives the transpose of each block
+    smat3x3 A  = smat3x3(lhs.rows[0].linear,  lhs.rows[1].linear,  lhs.rows[2].linear);  // symmetric
+    smat3x3 Bt = smat3x3(lhs.rows[0].angular, lhs.rows[1].angular, lhs.rows[2].angular);
+    smat3x3 C  = smat3x3(lhs.rows[3].angular, lhs.rows[4].angular, lhs.rows[5].angular); // symmetric
+
+    smat3x3 Ainv = inverseSymmetric(A);
+    smat3x3 AinvB = Ainv * glm::transpose(Bt);
+
+    // S = C - B^T A^-1 B
+    smat3x3 S = C - Bt * AinvB;
+
+    svec3 y = Ainv * rhs.linear;
+    svec3 angular = inverseSymmetric(S) * (rhs.angular - Bt * y);
+    svec3 linear = y - AinvB * angular;
+
+    return { linear, angular };
 }
\ No newline at end of file
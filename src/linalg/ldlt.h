@@ -5,5 +5,7 @@
 #include "mat6x6.h"
 
 vec6 solve(const mat6x6& lhs, const vec6& rhs);
+vec6 solveBlock(const mat6x6& lhs, const vec6& rhs);
+smat3x3 inverseSymmetric(const smat3x3& mat);
 
 #endif
\ No newline at end of file
@@ -11,13 +11,18 @@ struct mat3x6 {
     mat3x6(const vec6& r1, const vec6& r2, const vec6& r3);
 
     // operators
-    mat3x6& operator=(const mat3x6& rhs);
-    vec6& operator[](int i);
-    const vec6& operator[](int i) const;
-    mat3x6 operator*(float rhs) const;
+    vec6& operator[](int i) {
+        LINALG_ASSERT(i >= 0 && i <= 2, "mat3x6: index out of bounds.");
+        return rows[i];
+    }
+    const vec6& operator[](int i) const {
+        LINALG_ASSERT(i >= 0 && i <= 2, "mat3x6: index out of bounds.");
+        return rows[i];
+    }
+    mat3x6 operator*(solveScalar rhs) const;
 
     // multiplication helper
-    vec3 column(int i) const;
+    svec3 column(int i) const;
 };
 
 #endif
\ No newline at end of file
@@ -5,16 +5,22 @@
 #include "mat6x6.h"
 
 struct mat6x3 {
-    vec3 rows[6];
+    svec3 rows[6];
 
     mat6x3() = default;
     mat6x3(const mat3x6& transpose);
 
     // operators
-    vec3& operator[](int i);
-    const vec3& operator[](int i) const;
+    svec3& operator[](int i) {
+        LINALG_ASSERT(i >= 0 && i <= 5, "mat6x3: index out of bounds.");
+        return rows[i];
+    }
+    const svec3& operator[](int i) const {
+        LINALG_ASSERT(i >= 0 && i <= 5, "mat6x3: index out of bounds.");
+        return rows[i];
+    }
     mat6x6 operator*(const mat3x6& rhs) const;
-    mat6x3 operator*(float rhs) const;
+    mat6x3 operator*(solveScalar rhs) const;
 };
 
 mat6x3 transpose(const mat3x6& mat);
@@ -1,7 +1,18 @@
 #include "mat6x6.h"
+#include "util/byteStream.h"
+
+#ifdef LINALG_VALIDATION
+void writeFields(ByteWriter& out, const mat6x6& mat) {
+    out.write(mat.rows, 6);
+}
+
+bool readFields(ByteReader& in, mat6x6& mat) {
+    return in.read(mat.rows, 6);
+}
+#endif
 
 // used for creating mass matrix
-mat6x6::mat6x6(const mat3x3& tl, const mat3x3& tr, const mat3x3& bl, const mat3x3& br) {
+mat6x6::mat6x6(const smat3x3& tl, const smat3x3& tr, const smat3x3& bl, const smat3x3& br) {
     for (int i = 0; i < 3; i++) rows[i + 0] = vec6(tl[i][0], tl[i][1], tl[i][2], tr[i][0], tr[i][1], tr[i][2]);
     for (int i = 0; i < 3; i++) rows[i + 3] = vec6(bl[i][0], bl[i][1], bl[i][2], br[i][0], br[i][1], br[i][2]);
 }
@@ -15,25 +26,6 @@ mat6x6::mat6x6(const vec6& r1, const vec6& r2, const vec6& r3, const vec6& r4, c
     rows[5] = r6;
 }
 
-mat6x6::~mat6x6() {}
-
-// copy operator
-mat6x6& mat6x6::operator=(const mat6x6& rhs) {
-    if (&rhs == this) return *this;
-    for (int i = 0; i < 6; i++) rows[i] = rhs[i];
-    return *this;
-}
-
-vec6& mat6x6::operator[](int i) {
-    if (i < 0 || i > 5) throw std::runtime_error("mat6x6: index out of bounds.");
-    return rows[i];
-}
-
-const vec6& mat6x6::operator[](int i) const {
-    if (i < 0 || i > 5) throw std::runtime_error("mat6x6: index out of bounds.");
-    return rows[i];
-}
-
 mat6x6 mat6x6::operator+(const mat6x6& rhs) const {
     mat6x6 mat = mat6x6();
     for (int i = 0; i < 6; i++) mat[i] = (*this)[i] + rhs[i];
@@ -45,13 +37,13 @@ mat6x6& mat6x6::operator+=(const mat6x6& rhs) {
     return *this;
 }
 
-mat6x6 mat6x6::operator*(float rhs) const {
+mat6x6 mat6x6::operator*(solveScalar rhs) const {
     mat6x6 mat = mat6x6();
     for (int i = 0; i < 6; i++) mat[i] = (*this)[i] * rhs;
     return mat;
 }
 
-mat6x6 mat6x6::operator/(float rhs) const {
+mat6x6 mat6x6::operator/(solveScalar rhs) const {
     mat6x6 mat = mat6x6();
     for (int i = 0; i < 6; i++) mat[i] = (*this)[i] / rhs;
     return mat;
@@ -64,10 +56,14 @@ vec6 mat6x6::operator*(const vec6& rhs) const {
     return vec;
 }
 
-void mat6x6::addBottomRight(const mat3x3& mat) {
+void mat6x6::addBottomRight(const smat3x3& mat) {
     for (int i = 0; i < 3; i++) {
         for (int j = 0; j < 3; j++) {
             (*this)[i + 3][j + 3] += mat[i][j];
         }
     }
+}
+
+void mat6x6::addDiagonal(const vec6& diag) {
+    for (int i = 0; i < 6; i++) (*this)[i][i] += diag[i];
 }
\ No newline at end of file
@@ -8,21 +8,33 @@ struct mat6x6 {
     vec6 rows[6];
 
     mat6x6() = default;
-    mat6x6(const mat3x3& tl, const mat3x3& tr, const mat3x3& bl, const mat3x3& br);
+    mat6x6(const smat3x3& tl, const smat3x3& tr, const smat3x3& bl, const smat3x3& br);
     mat6x6(const vec6& r1, const vec6& r2, const vec6& r3, const vec6& r4, const vec6& r5, const vec6& r6);
-    ~mat6x6();
 
     // operators
-    mat6x6& operator=(const mat6x6& rhs);
-    vec6& operator[](int i);
-    const vec6& operator[](int i) const;
+    vec6& operator[](int i) {
+        LINALG_ASSERT(i >= 0 && i <= 5, "mat6x6: index out of bounds.");
+        return rows[i];
+    }
+    const vec6& operator[](int i) const {
+        LINALG_ASSERT(i >= 0 && i <= 5, "mat6x6: index out of bounds.");
+        return rows[i];
+    }
     mat6x6 operator+(const mat6x6& rhs) const;
     mat6x6& operator+=(const mat6x6& rhs);
-    mat6x6 operator*(float rhs) const;
+    mat6x6 operator*(solveScalar rhs) const;
     vec6 operator*(const vec6& rhs) const;
 
-    mat6x6 operator/(float rhs) const;
-    void addBottomRight(const mat3x3& mat);
+    mat6x6 operator/(solveScalar rhs) const;
+    void addBottomRight(const smat3x3& mat);
+    void addDiagonal(const vec6& diag);
 };
 
+#ifndef LINALG_VALIDATION
+static_assert(std::is_trivially_copyable<mat6x6>::value, "mat6x6 should be trivially copyable without LINALG_VALIDATION");
+#else
+void writeFields(ByteWriter& out, const mat6x6& mat);
+bool readFields(ByteReader& in, mat6x6& mat);
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include "util/includes.h"
+
+// lane type for the batched solvers, 8 floats with AVX2, 4 with SSE and a scalar fallback otherwise
+// double precision solves always use the scalar fallback
+#if defined(__AVX2__) && !defined(PRECISION_DOUBLE)
+
+#include <immintrin.h>
+#define SIMD_LANES 8
+
+struct floatN {
+    __m256 v;
+
+    floatN() = default;
+    floatN(__m256 v) : v(v) {}
+    floatN(float f) : v(_mm256_set1_ps(f)) {}
+
+    static floatN load(const float* p) { return _mm256_load_ps(p); }
+    void store(float* p) const { _mm256_store_ps(p, v); }
+};
+
+inline floatN operator+(floatN a, floatN b) { return _mm256_add_ps(a.v, b.v); }
+inline floatN operator-(floatN a, floatN b) { return _mm256_sub_ps(a.v, b.v); }
+inline floatN operator*(floatN a, floatN b) { return _mm256_mul_ps(a.v, b.v); }
+inline floatN operator/(floatN a, floatN b) { return _mm256_div_ps(a.v, b.v); }
+
+#elif (defined(__SSE2__) || defined(_M_X64)) && !defined(PRECISION_DOUBLE)
+
+#include <emmintrin.h>
+#define SIMD_LANES 4
+
+struct floatN {
+    __m128 v;
+
+    floatN() = default;
+    floatN(__m128 v) : v(v) {}
+    floatN(float f) : v(_mm_set1_ps(f)) {}
+
+    static floatN load(const float* p) { return _mm_load_ps(p); }
+    void store(float* p) const { _mm_store_ps(p, v); }
+};
+
+inline floatN operator+(floatN a, floatN b) { return _mm_add_ps(a.v, b.v); }
+inline floatN operator-(floatN a, floatN b) { return _mm_sub_ps(a.v, b.v); }
+inline floatN operator*(floatN a, floatN b) { return _mm_mul_ps(a.v, b.v); }
+inline floatN operator/(floatN a, floatN b) { return _mm_div_ps(a.v, b.v); }
+
+#else
+
+#define SIMD_LANES 4
+
+struct floatN {
+    solveScalar v[SIMD_LANES];
+
+    floatN() = default;
+    floatN(solveScalar f) { for (int l = 0; l < SIMD_LANES; l++) v[l] = f; }
+
+    static floatN load(const solveScalar* p) { floatN n; for (int l = 0; l < SIMD_LANES; l++) n.v[l] = p[l]; return n; }
+    void store(solveScalar* p) const { for (int l = 0; l < SIMD_LANES; l++) p[l] = v[l]; }
+};
+
+inline floatN operator+(floatN a, floatN b) { for (int l = 0; l < SIMD_LANES; l++) a.v[l] += b.v[l]; return a; }
+inline floatN operator-(floatN a, floatN b) { for (int l = 0; l < SIMD_LANES; l++) a.v[l] -= b.v[l]; return a; }
+inline floatN operator*(floatN a, floatN b) { for (int l = 0; l < SIMD_LANES; l++) a.v[l] *= b.v[l]; return a; }
+inline floatN operator/(floatN a, floatN b) { for (int l = 0; l < SIMD_LANES; l++) a.v[l] /= b.v[l]; return a; }
+
+#endif
+
+#define SIMD_ALIGN (SIMD_LANES * sizeof(solveScalar))
+
+#endif
@@ -1,4 +1,18 @@
 #include "vec6.h"
+#include "util/byteStream.h"
+
+#ifdef LINALG_VALIDATION
+void writeFields(ByteWriter& out, const vec6& vec) {
+    out.write(vec.linear);
+    out.write(vec.angular);
+}
+
+bool readFields(ByteReader& in, vec6& vec) {
+    svec3 linear, angular;
+    if (!in.read(linear) || !in.read(angular)) return false;
+    vec = vec6(linear, angular);
+    return true;
+}
 
 // copy operator
 vec6& vec6::operator=(const vec6& vec) {
@@ -12,6 +26,7 @@ vec6& vec6::operator=(const vec6& vec) {
 
     return *this;
 }
+#endif
 
 // inplace arithmetic
 vec6& vec6::operator+=(const vec6& rhs) {
@@ -19,27 +34,12 @@ vec6& vec6::operator+=(const vec6& rhs) {
     linear += rhs.linear;
     angular += rhs.angular;
 
-    if (hasNaN(linear)) throw std::runtime_error("vec6 += Linear component of copy has NaN");
-    if (hasNaN(angular)) throw std::runtime_error("vec6 += Angular component of copy has NaN");
+    LINALG_ASSERT(!hasNaN(linear), "vec6 += Linear component of copy has NaN");
+    LINALG_ASSERT(!hasNaN(angular), "vec6 += Angular component of copy has NaN");
 
     return *this;
 }
 
-// get item operators
-float& vec6::operator[](int i) {
-    if (i < 0 || i >= 6) {
-        throw std::out_of_range("vec6 index out of range");
-    }
-    return i < 3 ? linear[i] : angular[i - 3];
-}
-
-const float& vec6::operator[](int i) const {
-    if (i < 0 || i >= 6) {
-        throw std::out_of_range("vec6 index out of range");
-    }
-    return i < 3 ? linear[i] : angular[i - 3];
-}
-
 // arithmetic operators
 vec6 vec6::operator+(const vec6& rhs) const {
     return { linear + rhs.linear, angular + rhs.angular };
@@ -49,16 +49,22 @@ vec6 vec6::operator-(const vec6& rhs) const {
     return { linear - rhs.linear, angular - rhs.angular };
 }
 
-vec6 vec6::operator*(float rhs) const {
+vec6 vec6::operator*(solveScalar rhs) const {
     return { rhs * linear, rhs * angular };
 }
 
-vec6 vec6::operator/(float rhs) const {
-    if (rhs == 0.0f) throw std::runtime_error("Cannot divide by 0.");
+vec6 vec6::operator/(solveScalar rhs) const {
+    LINALG_ASSERT(rhs != 0.0f, "Cannot divide by 0.");
     return { linear / rhs, angular / rhs };
 }
 
 // math
-float dot(vec6 v1, vec6 v2) {
+solveScalar dot(vec6 v1, vec6 v2) {
     return glm::dot(v1.linear, v2.linear) + glm::dot(v1.angular, v2.angular);
-}
\ No newline at end of file
+}
+
+// largest absolute component
+solveScalar maxAbs(const vec6& v) {
+    svec3 m = glm::max(glm::abs(v.linear), glm::abs(v.angular));
+    return glm::max(m.x, glm::max(m.y, m.z));
+}
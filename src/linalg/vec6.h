@@ -3,43 +3,61 @@
 
 #include "util/includes.h"
 #include "debug_utils/debug.h"
+#include <type_traits>
 
 // commonly used data structures
 struct vec6 {
-    glm::vec3 linear;
-    glm::vec3 angular;
+    svec3 linear;
+    svec3 angular;
 
     vec6() = default;
-    vec6(const vec3& lin, const vec3& ang) : linear(lin), angular(ang) {
-        if (hasNaN(linear)) throw std::runtime_error("vec6(const vec3& lin, const vec3& ang) Linear component of copy has NaN");
-        if (hasNaN(angular)) throw std::runtime_error("vec6(const vec3& lin, const vec3& ang) Angular component of copy has NaN");
+    vec6(const svec3& lin, const svec3& ang) : linear(lin), angular(ang) {
+        LINALG_ASSERT(!hasNaN(linear), "vec6(const vec3& lin, const vec3& ang) Linear component of copy has NaN");
+        LINALG_ASSERT(!hasNaN(angular), "vec6(const vec3& lin, const vec3& ang) Angular component of copy has NaN");
     }
-    vec6(const vec6& vec) : linear(vec.linear), angular(vec.angular) {
-        if (hasNaN(linear)) throw std::runtime_error("vec6(const vec6& vec) Linear component of copy has NaN");
+    vec6(solveScalar x, solveScalar y, solveScalar z, solveScalar ax, solveScalar ay, solveScalar az) : linear(x, y, z), angular(ax, ay, az) {
+        LINALG_ASSERT(!hasNaN(linear), "vec6(float x, float y, float z, float ax, float ay, float az) Linear component of copy has NaN");
+        LINALG_ASSERT(!hasNaN(angular), "vec6(float x, float y, float z, float ax, float ay, float az) Angular component of copy has NaN");
     }
-    vec6(float x, float y, float z, float ax, float ay, float az) : linear(x, y, z), angular(ax, ay, az) {
-        if (std::isnan(x)) throw std::runtime_error("vec6(float x, float y, float z, float ax, float ay, float az) x component of copy has NaN");
-        if (std::isnan(y)) throw std::runtime_error("vec6(float x, float y, float z, float ax, float ay, float az) y component of copy has NaN");
-        if (std::isnan(z)) throw std::runtime_error("vec6(float x, float y, float z, float ax, float ay, float az) z component of copy has NaN");
-        if (std::isnan(ax)) throw std::runtime_error("vec6(float x, float y, float z, float ax, float ay, float az) ax component of copy has NaN");
-        if (std::isnan(ay)) throw std::runtime_error("vec6(float x, float y, float z, float ax, float ay, float az) ay component of copy has NaN");
-        if (std::isnan(az)) throw std::runtime_error("vec6(float x, float y, float z, float ax, float ay, float az) az component of copy has NaN");
+    vec6(solveScalar f) : linear(f), angular(f) {
+        LINALG_ASSERT(!std::isnan(f), "vec6(float f) f component of copy has NaN");
     }
-    vec6(float f) : linear(f), angular(f) {
-        if (std::isnan(f)) throw std::runtime_error("vec6(float f) f component of copy has NaN");
+
+#ifdef LINALG_VALIDATION
+    // checked copies, release builds keep the implicit trivial ones
+    vec6(const vec6& vec) : linear(vec.linear), angular(vec.angular) {
+        if (hasNaN(linear)) throw std::runtime_error("vec6(const vec6& vec) Linear component of copy has NaN");
     }
+    vec6& operator=(const vec6& vec);
+#endif
 
     // operators
-    vec6& operator=(const vec6& vec);
-    float& operator[](int i);
-    const float& operator[](int i) const;
+    solveScalar& operator[](int i) {
+        LINALG_ASSERT(i >= 0 && i < 6, "vec6 index out of range");
+        return i < 3 ? linear[i] : angular[i - 3];
+    }
+    const solveScalar& operator[](int i) const {
+        LINALG_ASSERT(i >= 0 && i < 6, "vec6 index out of range");
+        return i < 3 ? linear[i] : angular[i - 3];
+    }
     vec6 operator+(const vec6& rhs) const;
     vec6 operator-(const vec6& rhs) const;
-    vec6 operator*(float rhs) const;
-    vec6 operator/(float rhs) const;
+    vec6 operator*(solveScalar rhs) const;
+    vec6 operator/(solveScalar rhs) const;
     vec6& operator+=(const vec6& rhs);
 };
 
-float dot(vec6 v1, vec6 v2);
+#ifndef LINALG_VALIDATION
+static_assert(std::is_trivially_copyable<vec6>::value, "vec6 should be trivially copyable without LINALG_VALIDATION");
+#else
+// the checked copies aren't raw bytes, so snapshots write the components
+class ByteWriter;
+class ByteReader;
+void writeFields(ByteWriter& out, const vec6& vec);
+bool readFields(ByteReader& in, vec6& vec);
+#endif
+
+solveScalar dot(vec6 v1, vec6 v2);
+solveScalar maxAbs(const vec6& v);
 
-#endif
\ No newline at end of file
+#endif
@@ -4,6 +4,7 @@
 
 #include "render/engine.h"
 #include "solver.h"
+#include "scene.h"
 #include "util/random.h"
 #include <vector>
 #include <cstdlib>
@@ -11,23 +12,34 @@
 
 const bool STACK = false;
 
-int main() {
+int main(int argc, char** argv) {
     Solver solver;
     solver.gravity = vec3(0, -9.8f, 0);
     solver.iterations = 10;
 
-    // create ground plane (large flat box)
-    new Rigid(&solver, {15, 0.25f, 15}, -1.0f, 0.5f, {0, -1.0f, 0});
-
-    if (STACK) {
-            // scale = 
-        for (int i = 0; i < 7; ++i) {
-            new Rigid(&solver, vec3(0.5f), 10.0f, 0.4f, vec3(0.0f, i * 0.5 - 0.5, 0.0f), quat(1, 0, 0, 0), vec6());
+    // a scene file given on the command line replaces the built in scene
+    SceneFile scene;
+    if (argc > 1) {
+        if (!scene.open(argv[1])) {
+            std::cerr << "could not open scene " << argv[1] << std::endl;
+            return 1;
         }
+        scene.applyParams(solver);
+        scene.loadAll(solver);
     } else {
-        float diff = 0.5f;
-        for (int i = 0; i < 20; ++i) {
-            new Rigid(&solver, vec3(uniform(0.5f, 1.5f), uniform(0.5f, 1.5f), uniform(0.5f, 1.5f)), 10.0f, 0.4f, vec3(0.0f, i * 0.5 - 0.5, 0.0f) + vec3(uniform(-diff, diff), uniform(-diff, diff), uniform(-diff, diff)), quat(uniform(-diff, diff), uniform(-diff, diff), uniform(-diff, diff), uniform(-diff, diff)), vec6());
+        // create ground plane (large flat box)
+        new Rigid(&solver, {15, 0.25f, 15}, -1.0f, 0.5f, {0, -1.0f, 0});
+
+        if (STACK) {
+                // scale = 
+            for (int i = 0; i < 7; ++i) {
+                new Rigid(&solver, vec3(0.5f), 10.0f, 0.4f, vec3(0.0f, i * 0.5 - 0.5, 0.0f), quat(1, 0, 0, 0), vec6());
+            }
+        } else {
+            float diff = 0.5f;
+            for (int i = 0; i < 20; ++i) {
+                new Rigid(&solver, vec3(uniform(0.5f, 1.5f), uniform(0.5f, 1.5f), uniform(0.5f, 1.5f)), 10.0f, 0.4f, vec3(0.0f, i * 0.5 - 0.5, 0.0f) + vec3(uniform(-diff, diff), uniform(-diff, diff), uniform(-diff, diff)), quat(uniform(-diff, diff), uniform(-diff, diff), uniform(-diff, diff), uniform(-diff, diff)), vec6());
+            }
         }
     }
 
@@ -40,8 +52,8 @@ int main() {
         std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
         std::chrono::duration<float> dt = currentTime - lastFrameTime;
 
-        solver.step(dt.count());
-        engine.render();
+        solver.advance(dt.count());
+        engine.render(solver.interpolation);
         engine.update();
 
         lastFrameTime = currentTime;
@@ -1,10 +1,15 @@
 #include "threadPool.h"
 
+static thread_local const ThreadPool* currentPool = nullptr;
+static thread_local int currentWorker = -1;
+
 ThreadPool::ThreadPool(size_t numThreads) {
     for (size_t i = 0; i < numThreads; i++) {
-        workers.emplace_back([this] {
+        workers.emplace_back([this, i] {
+            currentPool = this;
+            currentWorker = (int) i;
             while (true) {
-                std::function<void()> task;
+                Task task;
 
                 {   // Critical section for queue
                     std::unique_lock<std::mutex> lock(queueMutex);
@@ -16,19 +21,12 @@ ThreadPool::ThreadPool(size_t numThreads) {
                         return;
 
                     task = std::move(tasks.front());
-                    tasks.pop();
+                    tasks.pop_front();
                     ++activeTasks;  // mark new active task
                 }
 
-                task();
-
-                {   // decrement active task count
-                    std::unique_lock<std::mutex> lock(queueMutex);
-                    --activeTasks;
-                    if (tasks.empty() && activeTasks == 0) {
-                        done_cv.notify_all();
-                    }
-                }
+                task.run();
+                finish(task.group);
             }
         });
     }
@@ -44,15 +42,38 @@ ThreadPool::~ThreadPool() {
         t.join();
 }
 
-template <typename F, typename... Args>
-void ThreadPool::enqueue(F&& f, Args&&... args) {
-    {
-        std::unique_lock<std::mutex> lock(queueMutex);
-        tasks.emplace([fn = std::forward<F>(f), ... args = std::forward<Args>(args)]() {
-            fn(args...);
-        });
+int ThreadPool::workerIndex() const {
+    return currentPool == this ? currentWorker : -1;
+}
+
+// decrements the active task count and wakes whoever waits for the pool or the task's group
+void ThreadPool::finish(TaskGroup* group) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    --activeTasks;
+    bool groupDone = group && --group->pending == 0;
+    if (groupDone || (tasks.empty() && activeTasks == 0)) {
+        done_cv.notify_all();
+    }
+}
+
+void ThreadPool::wait(TaskGroup& group) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (group.pending > 0) {
+        auto it = std::find_if(tasks.begin(), tasks.end(), [&group](const Task& task) { return task.group == &group; });
+        if (it == tasks.end()) {
+            // the rest of the group is running on workers
+            done_cv.wait(lock);
+            continue;
+        }
+
+        Task task = std::move(*it);
+        tasks.erase(it);
+        ++activeTasks;
+        lock.unlock();
+        task.run();
+        finish(task.group);
+        lock.lock();
     }
-    cv.notify_one();
 }
 
 void ThreadPool::wait() {
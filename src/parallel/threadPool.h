@@ -5,12 +5,25 @@
 #include <functional>
 #include <iostream>
 #include <mutex>
-#include <queue>
+#include <deque>
+#include <algorithm>
 #include <thread>
+#include <vector>
+
+// counts the unfinished tasks enqueued with it, so a caller can wait for its own work while other
+// callers keep using the same pool
+struct TaskGroup {
+    size_t pending = 0;
+};
 
 class ThreadPool {
+    struct Task {
+        std::function<void()> run;
+        TaskGroup* group; // null for tasks that only the whole pool wait covers
+    };
+
     std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
+    std::deque<Task> tasks;
 
     std::mutex queueMutex;
     std::condition_variable cv;
@@ -19,6 +32,8 @@ class ThreadPool {
     bool stop = false;
     size_t activeTasks = 0;
 
+    void finish(TaskGroup* group);
+
     public:
     ThreadPool(size_t numThreads);
     ~ThreadPool();
@@ -26,7 +41,60 @@ class ThreadPool {
     template <typename F, typename... Args>
     void enqueue(F&& f, Args&&... args);
 
+    template <typename F>
+    void enqueue(TaskGroup& group, F&& f);
+
+    // waits until the queue is empty and no task is running, including tasks of other callers
     void wait();
+
+    // waits for the tasks of one group and runs those still queued on the calling thread meanwhile,
+    // so it can be called from inside a task without taking a worker away from the group
+    void wait(TaskGroup& group);
+
+    size_t size() const { return workers.size(); }
+
+    // index of the worker running the calling thread, -1 on threads outside this pool
+    int workerIndex() const;
+
+    // splits [0, count) into one range per worker and waits for all of them
+    template <typename F>
+    void parallelFor(int count, F&& f);
 };
 
+template <typename F, typename... Args>
+void ThreadPool::enqueue(F&& f, Args&&... args) {
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        tasks.push_back({ std::bind(std::forward<F>(f), std::forward<Args>(args)...), nullptr });
+    }
+    cv.notify_one();
+}
+
+template <typename F>
+void ThreadPool::enqueue(TaskGroup& group, F&& f) {
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        tasks.push_back({ std::forward<F>(f), &group });
+        ++group.pending;
+    }
+    cv.notify_one();
+}
+
+template <typename F>
+void ThreadPool::parallelFor(int count, F&& f) {
+    int chunks = std::min((int) workers.size(), count);
+    if (chunks <= 1) {
+        if (count > 0) f(0, count);
+        return;
+    }
+
+    TaskGroup group;
+    for (int i = 0; i < chunks; i++) {
+        int begin = count * i / chunks;
+        int end = count * (i + 1) / chunks;
+        enqueue(group, [&f, begin, end] { f(begin, end); });
+    }
+    wait(group);
+}
+
 #endif
\ No newline at end of file
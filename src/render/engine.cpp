@@ -36,8 +36,8 @@ Engine::Engine(int width,
                const char* title,
                const char* vertexPath,
                const char* fragmentPath,
-               Rigid*& bodies,
-               Force*& forces
+               std::vector<Rigid*>& bodies,
+               std::vector<Force*>& forces
 )
     : window(nullptr), shader(nullptr), bodies(bodies), forces(forces)
 {
@@ -86,8 +86,8 @@ Engine::~Engine()
     glfwTerminate();
 }
 
-// Renders all rigid bodies from the associated PhysicsEngine
-void Engine::render() {
+// Renders all rigid bodies from the associated PhysicsEngine, alpha blends from the previous fixed step
+void Engine::render(float alpha) {
     // Clear the color and depth buffers
     glClearColor(0.2f, 0.2f, 0.2f, 1.0f); // Set background color
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -119,10 +119,10 @@ void Engine::render() {
         glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     #endif
     // Iterate through all rigid bodies in the physics engine and render them
-    for (Rigid* rigid = bodies; rigid != 0; rigid = rigid->next) {
+    for (Rigid* rigid : bodies) {
         // Calculate the model matrix for the current rigid body
         // This includes translation (position), rotation, and scaling
-        model = buildModelMatrix(rigid);
+        model = buildModelMatrix(rigid->interpolatedPosition(alpha), rigid->scale, rigid->interpolatedRotation(alpha));
 
         // Pass the model matrix to the shader
         shader->setMat4("model", model);
@@ -136,13 +136,13 @@ void Engine::render() {
     // render full shapes
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
     // render all forces
-    for (Force* force = forces; force != 0; force = force->next) {
+    for (Force* force : forces) {
         Manifold* man = (Manifold*) force;
 
         for (int i = 0; i < man->numContacts; i++) {
-            vec3 rA = transform(man->contacts[i].rA, man->bodyA);
-            vec3 rB = transform(man->contacts[i].rB, man->bodyB);
-            int type = man->contacts[i].type;
+            vec3 rA = transform(man->points[i].rA, man->bodyA);
+            vec3 rB = transform(man->points[i].rB, man->bodyB);
+            int type = man->points[i].type;
 
             #ifdef SHOW_CONTACT_POINTS
                 // graph rA
@@ -161,8 +161,8 @@ void Engine::render() {
             #ifdef SHOW_EPA_VERTICES
                 // project all minkowski points
                 for (int j = 0; j < 3; j++) {
-                    vec3 rA = transform(man->contacts[j].face.sps[j].indexA, man->bodyA);
-                    vec3 rB = transform(man->contacts[j].face.sps[j].indexB, man->bodyB);
+                    vec3 rA = transform(man->points[i].indexA[j], man->bodyA);
+                    vec3 rB = transform(man->points[i].indexB[j], man->bodyB);
 
                     model = buildModelMatrix(rA, vec3(0.05f), quat(1, 0, 0, 0));
                     shader->setMat4("model", model);
@@ -191,7 +191,7 @@ void Engine::render() {
 
             #ifdef SHOW_NORMALS
                 // graph normal
-                vec3 n = man->contacts[i].normal; // already world space
+                vec3 n = man->points[i].normal; // already world space
                 vec3 up = glm::abs(n.y) > 0.99f ? vec3(1,0,0) : vec3(0,1,0);
                 look = glm::quatLookAt(n, up);
 
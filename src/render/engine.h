@@ -33,8 +33,8 @@ class Camera {
 class Engine {
     GLFWwindow* window;
     Shader* shader;
-    Rigid*& bodies;
-    Force*& forces;
+    std::vector<Rigid*>& bodies;
+    std::vector<Force*>& forces;
     Camera camera;
     unsigned int VAO, VBOPositions, VBONormals, EBO;
 
@@ -51,13 +51,13 @@ class Engine {
         const char* title,
         const char* vertexShaderPath,
         const char* fragmentShaderPath,
-        Rigid*& bodies,
-        Force*& forces
+        std::vector<Rigid*>& bodies,
+        std::vector<Force*>& forces
     );
     ~Engine();
 
     
-    void render();
+    void render(float alpha = 1.0f);
     void update();
     bool shouldClose();
 
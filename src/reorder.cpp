@@ -0,0 +1,123 @@
+#include "solver.h"
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+// block of bodies laid out by reorderBodies, freed once every body in it is deleted
+struct alignas(std::max_align_t) BodyBlock {
+    size_t live;
+};
+
+// precedes every body, null for bodies allocated on their own by new
+struct alignas(std::max_align_t) BodyHeader {
+    BodyBlock* block;
+};
+
+void* Rigid::operator new(size_t size) {
+    BodyHeader* header = static_cast<BodyHeader*>(::operator new(sizeof(BodyHeader) + size));
+    header->block = nullptr;
+    return header + 1;
+}
+
+void Rigid::operator delete(void* body) {
+    if (body == nullptr) return;
+    BodyHeader* header = static_cast<BodyHeader*>(body) - 1;
+    if (header->block == nullptr) ::operator delete(header);
+    else if (--header->block->live == 0) ::operator delete(header->block);
+}
+
+// spreads the low 21 bits of x so there are two zero bits between each of them
+static uint64_t spreadBits(uint64_t x) {
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x001f00000000ffffull;
+    x = (x | x << 16) & 0x001f0000ff0000ffull;
+    x = (x | x << 8) & 0x100f00f00f00f00full;
+    x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+    x = (x | x << 2) & 0x1249249249249249ull;
+    return x;
+}
+
+// sorts the body array along a Morton curve through the bounds of all bodies and moves the bodies
+// into one block in that order, then sorts the force array by the position of their first body in
+// it. Islands, the adjacency and batches are built in these orders, so a sweep moves through a pile
+// region by region and through memory front to back
+void Solver::reorderBodies() {
+    if (bodies.empty()) return;
+
+    pvec3 lo = bodies[0]->position;
+    pvec3 hi = lo;
+    for (Rigid* body : bodies) {
+        lo = glm::min(lo, body->position);
+        hi = glm::max(hi, body->position);
+    }
+
+    // quantize to 21 bits per axis
+    pvec3 extent = glm::max(hi - lo, pvec3((scalar) 1e-6f));
+    pvec3 scale = pvec3((scalar) 0x1fffff) / extent;
+
+    std::vector<std::pair<uint64_t, Rigid*>> keys(bodies.size());
+    for (size_t i = 0; i < bodies.size(); i++) {
+        pvec3 cell = (bodies[i]->position - lo) * scale;
+        keys[i] = { spreadBits((uint64_t) cell.x) | spreadBits((uint64_t) cell.y) << 1 | spreadBits((uint64_t) cell.z) << 2, bodies[i] };
+    }
+
+    // ties broken by id so the order doesn't depend on the previous one
+    std::sort(keys.begin(), keys.end(), [](const std::pair<uint64_t, Rigid*>& a, const std::pair<uint64_t, Rigid*>& b) {
+        return a.first != b.first ? a.first < b.first : a.second->id < b.second->id;
+    });
+    for (int i = 0; i < (int) bodies.size(); i++) {
+        bodies[i] = keys[i].second;
+        bodies[i]->index = i;
+    }
+
+    relocateBodies();
+
+    // forces on static bodies or the world sort by their other body
+    auto first = [](const Force* force) {
+        int a = force->bodyA && force->bodyA->mass > 0 ? force->bodyA->index : INT32_MAX;
+        int b = force->bodyB && force->bodyB->mass > 0 ? force->bodyB->index : INT32_MAX;
+        return std::min(a, b);
+    };
+    std::sort(forces.begin(), forces.end(), [&](const Force* a, const Force* b) {
+        int ka = first(a), kb = first(b);
+        return ka != kb ? ka < kb : a->id < b->id;
+    });
+    for (int i = 0; i < (int) forces.size(); i++) forces[i]->index = i;
+}
+
+// copies every body into a new block in array order and points all references at the copies,
+// the old bodies are released without running their destructors since nothing was removed
+void Solver::relocateBodies() {
+    size_t count = bodies.size();
+    const size_t align = alignof(std::max_align_t);
+    size_t stride = sizeof(BodyHeader) + (sizeof(Rigid) + align - 1) / align * align;
+
+    BodyBlock* block = static_cast<BodyBlock*>(::operator new(sizeof(BodyBlock) + stride * count));
+    block->live = count;
+
+    FrameArena& arena = frameArena();
+    FrameArena::Scope scope(arena);
+    ArenaVector<Rigid*> moved(count, nullptr, arena);
+    unsigned char* slot = reinterpret_cast<unsigned char*>(block + 1);
+    for (size_t i = 0; i < count; i++, slot += stride) {
+        BodyHeader* header = new (slot) BodyHeader{ block };
+        moved[i] = new (header + 1) Rigid(*bodies[i]);
+    }
+
+    // the old bodies still hold their indices, so every reference maps through them
+    auto to = [&moved](Rigid* body) { return body ? moved[body->index] : nullptr; };
+    // parents may point at removed bodies until buildIslands resets them
+    for (Rigid* body : moved) body->islandParent = islandsDirty ? body : to(body->islandParent);
+    for (Force* force : forces) {
+        force->bodyA = to(force->bodyA);
+        force->bodyB = to(force->bodyB);
+    }
+    for (Island& island : islands)
+        for (Rigid*& body : island.bodies) body = to(body);
+    bodyHandles.remap(to);
+
+    for (size_t i = 0; i < count; i++) {
+        Rigid::operator delete(bodies[i]);
+        bodies[i] = moved[i];
+    }
+}
@@ -1,10 +1,9 @@
 #include "rigid.h"
 
 Rigid::Rigid(Solver* solver, vec3 size, float density, float friction,
-             vec3 position, quat rotation, vec6 velocity, vec4 color)
+             pvec3 position, quat rotation, vec6 velocity, vec4 color)
     :   solver(solver),
         forces(nullptr), 
-        next(nullptr),
         position(position), 
         rotation(glm::normalize(rotation)),
         velocity(velocity), 
@@ -13,13 +12,23 @@ Rigid::Rigid(Solver* solver, vec3 size, float density, float friction,
         inertialPosition(),
         initialRotation(),
         inertialRotation(),
+        prevPosition(position),
+        prevRotation(glm::normalize(rotation)),
         scale(size), 
         friction(friction), 
+        islandParent(this),
+        islandRank(0),
+        island(-1),
+        sleeping(false),
+        sleepTimer(0.0f),
         color(color)
 {
-    // Add to linked list
-    next = solver->bodies;
-    solver->bodies = this;
+    id = solver->nextBodyId++;
+
+    // add to the dense body array
+    index = (int) solver->bodies.size();
+    solver->bodies.push_back(this);
+    handle = solver->bodyHandles.insert(this);
 
     mass = scale.x * scale.y * scale.z * density;
     float invMass = 1.0f / mass;
@@ -34,28 +43,66 @@ Rigid::Rigid(Solver* solver, vec3 size, float density, float friction,
             {0, Iyy, 0},
             {0, 0, Izz}
         );
+        invInertiaTensor = mat3x3(
+            {1.0f / Ixx, 0, 0},
+            {0, 1.0f / Iyy, 0},
+            {0, 0, 1.0f / Izz}
+        );
     } else {
         inertiaTensor = mat3x3({0,0,0}, {0,0,0}, {0,0,0});
+        invInertiaTensor = mat3x3({0,0,0}, {0,0,0}, {0,0,0});
     }
+    worldInertia = inertiaTensor;
+    invWorldInertia = invInertiaTensor;
     radius = glm::length(scale); // max half extent magnitude
 }
 
+Rigid::Rigid(Solver* solver, const BodyDesc& desc)
+    :   Rigid(solver, desc.size, desc.density, desc.friction, desc.position, desc.rotation, desc.velocity, desc.color) {}
+
 Rigid::~Rigid() {
-    // Remove from linked list
-    Rigid** p = &solver->bodies;
-    while (*p != this)
-        p = &(*p)->next;
-    *p = next;
+    // other bodies may point to this one in the island union-find
+    solver->islandsDirty = true;
+
+    // bodies resting on this one lose their support
+    solver->wakeIsland(this);
+    for (Force* f = forces; f != nullptr; f = (f->bodyA == this) ? f->nextA : f->nextB)
+        solver->wakeIsland(f->bodyA == this ? f->bodyB : f->bodyA);
+
+    // forces can't outlive either of their bodies
+    while (forces) forces->destroy();
+    solver->leaveIsland(this);
+
+    // swap remove from the dense body array
+    Rigid* last = solver->bodies.back();
+    solver->bodies[index] = last;
+    last->index = index;
+    solver->bodies.pop_back();
+    solver->bodyHandles.erase(handle);
 }
 
 bool Rigid::constrainedTo(Rigid* other) const {
     // check if this body is constrained to the other body
-    for (Force* f = forces; f != nullptr; f = f->next)
+    for (Force* f = forces; f != nullptr; f = (f->bodyA == this) ? f->nextA : f->nextB)
         if ((f->bodyA == this && f->bodyB == other) || (f->bodyA == other && f->bodyB == this)) 
             return true;
     return false;
 }
 
+void Rigid::wake() {
+    solver->wakeIsland(this);
+}
+
+// applies an impulse at a world space point and wakes the body
+void Rigid::applyImpulse(const vec3& impulse, const vec3& point) {
+    if (mass <= 0) return;
+    wake();
+
+    mat3x3 R(rotation);
+    velocity.linear += impulse / mass;
+    velocity.angular += R * invInertiaTensor * glm::transpose(R) * glm::cross(vec3(pvec3(point) - position), impulse);
+}
+
 mat6x6 Rigid::getMassMatrix() const {
     mat3x3 topLeft = mass * glm::mat3x3(1.0f);
     mat3x3 bottomRight = getInertiaTensor();
@@ -68,6 +115,23 @@ mat3x3 Rigid::getInertiaTensor() const {
     return R * inertiaTensor * glm::transpose(R);
 }
 
+void Rigid::updateInertia(float dt) {
+    mat3x3 R(rotation);
+    mat3x3 RT = glm::transpose(R);
+    worldInertia = R * inertiaTensor * RT;
+    invWorldInertia = R * invInertiaTensor * RT;
+
+    mat6x6 M = { mass * glm::mat3x3(1.0f), mat3x3(), mat3x3(), worldInertia };
+    scaledMass = M / (dt * dt);
+}
+
+// applies a primal solution (Eq. 4)
+void Rigid::displace(const vec6& delta) {
+    position -= delta.linear;
+    quat dq = quat(0.0f, delta.angular);
+    rotation = glm::normalize(rotation - 0.5f * (dq * rotation));
+}
+
 vec3 Rigid::deltaWInitial() const {
     quat rel = 2.0f * (rotation * glm::inverse(initialRotation));
     return {rel.x, rel.y, rel.z};
@@ -78,9 +142,18 @@ vec3 Rigid::deltaWInertial() const {
     return {rel.x, rel.y, rel.z};
 }
 
+vec3 Rigid::interpolatedPosition(float t) const {
+    return vec3(glm::mix(prevPosition, position, (scalar) t));
+}
+
+quat Rigid::interpolatedRotation(float t) const {
+    return glm::slerp(prevRotation, rotation, t);
+}
+
 // helper functions
+
 mat4x4 buildModelMatrix(const Rigid* b) {
-    mat4x4 translation = glm::translate(mat4x4(1), b->position);
+    mat4x4 translation = glm::translate(mat4x4(1), vec3(b->position));
     mat4x4 scaling = glm::scale(mat4x4(1), b->scale);
     mat4x4 rotate = mat4x4(b->rotation);
 
@@ -96,7 +169,7 @@ mat4x4 buildModelMatrix(const vec3& pos, const vec3& sca, const quat& rot) {
 }
 
 glm::mat4 buildInverseModelMatrix(const Rigid* b) {
-    glm::mat4 invTranslation = glm::translate(glm::mat4(1), -b->position);
+    glm::mat4 invTranslation = glm::translate(glm::mat4(1), -vec3(b->position));
     glm::mat4 invRotation = glm::mat4(glm::conjugate(b->rotation));
     glm::mat4 invScaling = glm::scale(glm::mat4(1), 1.0f / b->scale);
     
@@ -105,7 +178,7 @@ glm::mat4 buildInverseModelMatrix(const Rigid* b) {
 
 glm::vec3 inverseTransform(const glm::vec3& worldPoint, Rigid* body) {
     // Undo translation
-    glm::vec3 p = worldPoint - body->position;
+    glm::vec3 p = vec3(pvec3(worldPoint) - body->position);
 
     // Undo rotation
     glm::quat invRot = glm::conjugate(glm::normalize(body->rotation));
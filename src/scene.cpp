@@ -0,0 +1,292 @@
+#include "scene.h"
+#include "rigid.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// records are read in place, so files are only usable on hosts with the same byte order
+static bool littleEndian() {
+    uint16_t probe = 1;
+    uint8_t first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+// the layout is part of the format
+static_assert(sizeof(SceneShape) == 20 && sizeof(SceneRegion) == 32 && sizeof(SceneBody) == 72, "scene records changed size");
+static_assert(sizeof(SceneHeader) == 96, "scene header changed size");
+
+static uint64_t align8(uint64_t offset) { return (offset + 7) & ~(uint64_t) 7; }
+
+// true if count records of the given size fit in the file at offset
+static bool fits(uint64_t offset, uint64_t count, uint64_t record, size_t size) {
+    return offset % 8 == 0 && offset <= size && count <= (size - offset) / record;
+}
+
+bool SceneFile::open(const char* path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER length;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &length) && length.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == nullptr) return false;
+    size = (size_t) length.QuadPart;
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+        view = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+    size = (size_t) info.st_size;
+#endif
+
+    data = (const uint8_t*) view;
+    mapped = true;
+    if (validate()) return true;
+    close();
+    return false;
+}
+
+bool SceneFile::open(const uint8_t* bytes, size_t length) {
+    close();
+    data = bytes;
+    size = length;
+    if (validate()) return true;
+    close();
+    return false;
+}
+
+void SceneFile::close() {
+    if (mapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+#else
+        munmap((void*) data, size);
+#endif
+    }
+    data = nullptr;
+    size = 0;
+    mapped = false;
+}
+
+// only the header and region table are checked, bodies are checked as their region is loaded
+// so opening a file doesn't touch every page of it
+bool SceneFile::validate() {
+    if (!littleEndian() || data == nullptr || size < sizeof(SceneHeader)) return false;
+
+    const SceneHeader& h = header();
+    if (std::memcmp(h.magic, "BSCN", 4) != 0 || h.version != SCENE_VERSION || h.jointCount != 0) return false;
+    if (!fits(h.shapesOffset, h.shapeCount, sizeof(SceneShape), size)) return false;
+    if (!fits(h.regionsOffset, h.regionCount, sizeof(SceneRegion), size)) return false;
+    if (!fits(h.bodiesOffset, h.bodyCount, sizeof(SceneBody), size)) return false;
+
+    for (uint32_t i = 0; i < h.regionCount; i++) {
+        const SceneRegion& region = regions()[i];
+        if (region.firstBody > h.bodyCount || region.bodyCount > h.bodyCount - region.firstBody) return false;
+    }
+
+    // applyParams copies these straight into the solver, which divides by the timestep and substeps
+    const SceneParams& p = h.params;
+    if (!std::isfinite(p.timestep) || p.timestep <= 0.0f || p.substeps <= 0 || p.iterations < 0) return false;
+    for (float g : p.gravity) if (!std::isfinite(g)) return false;
+    if (!std::isfinite(p.alpha) || !std::isfinite(p.beta) || !std::isfinite(p.gamma)) return false;
+    return true;
+}
+
+void SceneFile::applyParams(Solver& solver) const {
+    const SceneParams& p = header().params;
+    solver.gravity = vec3(p.gravity[0], p.gravity[1], p.gravity[2]);
+    solver.iterations = p.iterations;
+    solver.alpha = p.alpha;
+    solver.beta = p.beta;
+    solver.gamma = p.gamma;
+    solver.timestep = p.timestep;
+    solver.substeps = p.substeps;
+    solver.allowSleep = p.allowSleep != 0;
+}
+
+void SceneFile::loadRegion(Solver& solver, int region, std::vector<BodyHandle>& handles) const {
+    const SceneRegion& r = regions()[region];
+    const SceneShape* shapeTable = shapes();
+    uint32_t shapeCount = header().shapeCount;
+
+    // the solver arrays grow geometrically, reserving exactly per region would copy them every region
+    handles.reserve(handles.size() + r.bodyCount);
+
+    const SceneBody* body = bodies() + r.firstBody;
+    for (uint32_t i = 0; i < r.bodyCount; i++, body++) {
+        if (body->shape >= shapeCount) continue;
+        const SceneShape& shape = shapeTable[body->shape];
+
+        Rigid* rigid = new Rigid(&solver,
+            vec3(shape.size[0], shape.size[1], shape.size[2]), shape.density, shape.friction,
+            pvec3(body->position[0], body->position[1], body->position[2]),
+            quat(body->rotation[0], body->rotation[1], body->rotation[2], body->rotation[3]),
+            vec6(svec3(body->velocity[0], body->velocity[1], body->velocity[2]), svec3(body->velocity[3], body->velocity[4], body->velocity[5])),
+            vec4(body->color[0], body->color[1], body->color[2], body->color[3]));
+        handles.push_back(rigid->handle);
+    }
+}
+
+void SceneFile::loadAll(Solver& solver) const {
+    solver.bodies.reserve(solver.bodies.size() + header().bodyCount);
+    solver.bodyHandles.reserve(solver.bodies.size() + header().bodyCount);
+
+    std::vector<BodyHandle> handles;
+    for (uint32_t i = 0; i < header().regionCount; i++) {
+        loadRegion(solver, i, handles);
+        handles.clear();
+    }
+}
+
+SceneStreamer::SceneStreamer(const SceneFile& file, Solver& solver)
+    : file(file), solver(solver), loaded(file.header().regionCount), resident(file.header().regionCount, false) {}
+
+int SceneStreamer::update(vec3 center, float radius) {
+    int changed = 0;
+    for (int i = 0; i < (int) resident.size(); i++) {
+        // distance from the center to the region bounds
+        const SceneRegion& region = file.regions()[i];
+        vec3 closest = glm::clamp(center, vec3(region.min[0], region.min[1], region.min[2]), vec3(region.max[0], region.max[1], region.max[2]));
+        float distance = glm::length(center - closest);
+
+        if (!resident[i] && distance <= radius) {
+            file.loadRegion(solver, i, loaded[i]);
+            resident[i] = true;
+            changed++;
+        } else if (resident[i] && distance > radius * unloadMargin) {
+            solver.destroyBodies(loaded[i].data(), (int) loaded[i].size());
+            loaded[i].clear();
+            resident[i] = false;
+            changed++;
+        }
+    }
+    return changed;
+}
+
+void SceneStreamer::unloadAll() {
+    for (int i = 0; i < (int) resident.size(); i++) {
+        if (!resident[i]) continue;
+        solver.destroyBodies(loaded[i].data(), (int) loaded[i].size());
+        loaded[i].clear();
+        resident[i] = false;
+    }
+}
+
+bool writeScene(const char* path, const Solver& solver, float regionSize) {
+    if (!littleEndian() || regionSize <= 0.0f) return false;
+
+    // shapes are shared by every body with the same size, density and friction
+    std::map<std::array<float, 5>, uint32_t> shapeIndex;
+    std::vector<SceneShape> shapes;
+
+    // regions in cell order, bodies keep their array order within a region
+    std::map<std::array<int, 3>, std::vector<const Rigid*>> cells;
+    for (const Rigid* body : solver.bodies) {
+        vec3 p = vec3(body->position) / regionSize;
+        cells[{ (int) std::floor(p.x), (int) std::floor(p.y), (int) std::floor(p.z) }].push_back(body);
+    }
+
+    std::vector<SceneRegion> regions;
+    std::vector<SceneBody> bodies;
+    bodies.reserve(solver.bodies.size());
+    for (const auto& cell : cells) {
+        SceneRegion region = { { INFINITY, INFINITY, INFINITY }, { -INFINITY, -INFINITY, -INFINITY }, (uint32_t) bodies.size(), (uint32_t) cell.second.size() };
+
+        for (const Rigid* body : cell.second) {
+            // static bodies were created with a negative density, which is all the mass keeps of it
+            float density = body->mass / (body->scale.x * body->scale.y * body->scale.z);
+            std::array<float, 5> key = { body->scale.x, body->scale.y, body->scale.z, density, body->friction };
+            auto found = shapeIndex.find(key);
+            if (found == shapeIndex.end()) {
+                found = shapeIndex.emplace(key, (uint32_t) shapes.size()).first;
+                shapes.push_back({ { key[0], key[1], key[2] }, density, body->friction });
+            }
+
+            SceneBody record;
+            record.shape = found->second;
+            vec3 position = vec3(body->position);
+            for (int k = 0; k < 3; k++) record.position[k] = position[k];
+            record.rotation[0] = body->rotation.w;
+            record.rotation[1] = body->rotation.x;
+            record.rotation[2] = body->rotation.y;
+            record.rotation[3] = body->rotation.z;
+            for (int k = 0; k < 3; k++) {
+                record.velocity[k] = (float) body->velocity.linear[k];
+                record.velocity[k + 3] = (float) body->velocity.angular[k];
+            }
+            for (int k = 0; k < 4; k++) record.color[k] = body->color[k];
+            bodies.push_back(record);
+
+            // bounds cover the broadphase sphere so streaming never misses part of a body
+            for (int k = 0; k < 3; k++) {
+                region.min[k] = std::min(region.min[k], position[k] - body->radius);
+                region.max[k] = std::max(region.max[k], position[k] + body->radius);
+            }
+        }
+        regions.push_back(region);
+    }
+
+    SceneHeader header;
+    std::memset(&header, 0, sizeof(header)); // padding is written out as well
+    std::memcpy(header.magic, "BSCN", 4);
+    header.version = SCENE_VERSION;
+    header.shapeCount = (uint32_t) shapes.size();
+    header.regionCount = (uint32_t) regions.size();
+    header.bodyCount = (uint32_t) bodies.size();
+    header.jointCount = 0;
+    header.shapesOffset = align8(sizeof(SceneHeader));
+    header.regionsOffset = align8(header.shapesOffset + shapes.size() * sizeof(SceneShape));
+    header.bodiesOffset = align8(header.regionsOffset + regions.size() * sizeof(SceneRegion));
+    header.jointsOffset = align8(header.bodiesOffset + bodies.size() * sizeof(SceneBody));
+
+    SceneParams& params = header.params;
+    for (int k = 0; k < 3; k++) params.gravity[k] = solver.gravity[k];
+    params.iterations = solver.iterations;
+    params.alpha = solver.alpha;
+    params.beta = solver.beta;
+    params.gamma = solver.gamma;
+    params.timestep = solver.timestep;
+    params.substeps = solver.substeps;
+    params.allowSleep = solver.allowSleep;
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    auto section = [&file](uint64_t offset, const void* bytes, size_t length) {
+        static const char zeros[8] = {};
+        file.write(zeros, offset - (uint64_t) file.tellp());
+        file.write((const char*) bytes, length);
+    };
+    section(0, &header, sizeof(header));
+    section(header.shapesOffset, shapes.data(), shapes.size() * sizeof(SceneShape));
+    section(header.regionsOffset, regions.data(), regions.size() * sizeof(SceneRegion));
+    section(header.bodiesOffset, bodies.data(), bodies.size() * sizeof(SceneBody));
+    return (bool) file;
+}
@@ -0,0 +1,114 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "solver.h"
+#include <cstdint>
+
+// Binary scene files, little-endian and made of fixed size records so they can be mapped and read in place.
+//
+//   SceneHeader
+//   SceneShape[shapeCount]      box shapes shared between bodies
+//   SceneRegion[regionCount]    spatial chunks, each owning a contiguous run of bodies
+//   SceneBody[bodyCount]        sorted by region
+//
+// Sections start at the offsets in the header, which are multiples of 8 from the start of the file.
+
+#define SCENE_VERSION 1
+
+struct SceneParams {
+    float gravity[3];
+    int32_t iterations;
+    float alpha;
+    float beta;
+    float gamma;
+    float timestep;
+    int32_t substeps;
+    uint32_t allowSleep;
+};
+
+struct SceneHeader {
+    char magic[4]; // "BSCN"
+    uint32_t version;
+    uint32_t shapeCount;
+    uint32_t regionCount;
+    uint32_t bodyCount;
+    uint32_t jointCount; // reserved for joint records, always 0 since the solver only has contacts
+    uint64_t shapesOffset;
+    uint64_t regionsOffset;
+    uint64_t bodiesOffset;
+    uint64_t jointsOffset;
+    SceneParams params;
+};
+
+struct SceneShape {
+    float size[3];
+    float density; // negative for static bodies
+    float friction;
+};
+
+struct SceneRegion {
+    float min[3]; // bounds of the bodies in the region, each position padded by the body's radius
+    float max[3];
+    uint32_t firstBody;
+    uint32_t bodyCount;
+};
+
+struct SceneBody {
+    uint32_t shape;
+    float position[3];
+    float rotation[4]; // w, x, y, z
+    float velocity[6]; // linear, angular
+    float color[4];
+};
+
+// read only view of a scene file, mapped from disk or borrowed from memory
+class SceneFile {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    bool mapped = false; // false for borrowed memory
+
+    bool validate();
+
+    public:
+    SceneFile() = default;
+    ~SceneFile() { close(); }
+    SceneFile(const SceneFile&) = delete;
+    SceneFile& operator=(const SceneFile&) = delete;
+
+    bool open(const char* path); // maps the file, false if it can't be mapped or isn't a valid scene
+    bool open(const uint8_t* bytes, size_t length); // the bytes must outlive the SceneFile
+    void close();
+
+    const SceneHeader& header() const { return *(const SceneHeader*) data; }
+    const SceneShape* shapes() const { return (const SceneShape*) (data + header().shapesOffset); }
+    const SceneRegion* regions() const { return (const SceneRegion*) (data + header().regionsOffset); }
+    const SceneBody* bodies() const { return (const SceneBody*) (data + header().bodiesOffset); }
+
+    void applyParams(Solver& solver) const;
+
+    // creates the bodies of one region in file order, their handles are appended so they can be unloaded
+    void loadRegion(Solver& solver, int region, std::vector<BodyHandle>& handles) const;
+    void loadAll(Solver& solver) const;
+};
+
+// keeps the regions of a scene within a radius of a point loaded, startup only pays for what is nearby
+class SceneStreamer {
+    const SceneFile& file;
+    Solver& solver;
+    std::vector<std::vector<BodyHandle>> loaded; // bodies per region, empty while the region is not resident
+    std::vector<bool> resident;
+
+    public:
+    float unloadMargin = 1.25f; // regions unload beyond radius * unloadMargin so they don't flicker at the edge
+
+    SceneStreamer(const SceneFile& file, Solver& solver);
+
+    // loads regions overlapping the sphere and unloads those that left it, returns the number of regions changed
+    int update(vec3 center, float radius);
+    void unloadAll();
+};
+
+// writes the bodies of a solver as a scene, grouped into cubic regions of regionSize
+bool writeScene(const char* path, const Solver& solver, float regionSize);
+
+#endif
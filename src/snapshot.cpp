@@ -0,0 +1,422 @@
+#include "solver.h"
+
+// Layout, every value in host byte order:
+//   header            magic, version, body and force counts
+//   body table        handle and id per body in array order
+//   body state        bodyFields per body, then its island parent as a body index
+//   force table       handle, id, whether it is a contact, and body indices per force in array order
+//   force state       forceFields and Force::save per force
+//   links             force chain head per body, nextA and nextB per force, as force indices
+//   handle tables     bodies then forces
+//   islands           from the last step, bodies and forces as indices
+//   solver state      solverFields
+// Solver parameters are configuration and are not part of a snapshot.
+
+static const uint32_t SNAPSHOT_MAGIC = 0x50414e53; // "SNAP"
+static const uint32_t SNAPSHOT_VERSION = 1;
+
+// every mutable field of a body, links to other objects are stored separately as indices
+template <typename B, typename F>
+static void bodyFields(B* body, F&& field) {
+    field(body->position);
+    field(body->rotation);
+    field(body->velocity);
+    field(body->prevVelocity);
+    field(body->initialPosition);
+    field(body->initialRotation);
+    field(body->inertialPosition);
+    field(body->inertialRotation);
+    field(body->prevPosition);
+    field(body->prevRotation);
+    field(body->iteratePosition);
+    field(body->iterateRotation);
+    field(body->scale);
+    field(body->mass);
+    field(body->inertiaTensor);
+    field(body->invInertiaTensor);
+    field(body->friction);
+    field(body->radius);
+    field(body->worldInertia);
+    field(body->invWorldInertia);
+    field(body->scaledMass);
+    field(body->islandRank);
+    field(body->island);
+    field(body->sleeping);
+    field(body->sleepTimer);
+    field(body->color);
+}
+
+// rows shared by every force type, the rest is written by Force::save
+template <typename T, typename F>
+static void forceFields(T* force, F&& field) {
+    field(force->C);
+    field(force->fmin);
+    field(force->fmax);
+    field(force->stiffness);
+    field(force->motor);
+    field(force->fracture);
+    field(force->penalty);
+    field(force->lambda);
+    field(force->inIsland);
+}
+
+template <typename S, typename F>
+static void solverFields(S* solver, F&& field) {
+    field(solver->accumulator);
+    field(solver->interpolation);
+    field(solver->nextBodyId);
+    field(solver->nextForceId);
+    field(solver->stepHash);
+    field(solver->stepsSinceReorder);
+    field(solver->islandsDirty);
+    field(solver->stepIterations);
+    field(solver->stepPrimalResidual);
+    field(solver->stepDualResidual);
+    field(solver->stepTimedOut);
+}
+
+static int32_t indexOf(const Rigid* body) { return body ? body->index : -1; }
+static int32_t indexOf(const Force* force) { return force ? force->index : -1; }
+
+void Solver::saveSnapshot(std::vector<uint8_t>& buffer) const {
+    // writes over the bytes of the last snapshot, so saving every frame doesn't allocate
+    buffer.clear();
+    ByteWriter out(buffer);
+    auto write = [&out](const auto& value) { out.write(value); };
+
+    out.write(SNAPSHOT_MAGIC);
+    out.write(SNAPSHOT_VERSION);
+    out.write((uint32_t) bodies.size());
+    out.write((uint32_t) forces.size());
+
+    for (const Rigid* body : bodies) {
+        out.write(body->handle);
+        out.write(body->id);
+    }
+    for (const Rigid* body : bodies) {
+        bodyFields(body, write);
+        out.write(indexOf(body->islandParent));
+    }
+
+    for (const Force* force : forces) {
+        out.write(force->handle);
+        out.write(force->id);
+        out.write((uint8_t) (dynamic_cast<const Manifold*>(force) != nullptr));
+        out.write(indexOf(force->bodyA));
+        out.write(indexOf(force->bodyB));
+    }
+    for (const Force* force : forces) {
+        forceFields(force, write);
+        force->save(out);
+    }
+
+    for (const Rigid* body : bodies) out.write(indexOf(body->forces));
+    for (const Force* force : forces) {
+        out.write(indexOf(force->nextA));
+        out.write(indexOf(force->nextB));
+    }
+
+    bodyHandles.save(out, [](const Rigid* body) { return body->index; });
+    forceHandles.save(out, [](const Force* force) { return force->index; });
+
+    out.write((uint32_t) islands.size());
+    for (const Island& island : islands) {
+        out.write(island.sleeping);
+        out.write(island.iterations);
+        out.write(island.primalResidual);
+        out.write(island.dualResidual);
+        out.write(island.timedOut);
+        out.write((uint32_t) island.bodies.size());
+        for (const Rigid* body : island.bodies) out.write(body->index);
+        out.write((uint32_t) island.forces.size());
+        for (const Force* force : island.forces) out.write(force->index);
+    }
+
+    solverFields(this, write);
+}
+
+// the rows forceFields visits, for reading past forces that don't exist yet
+struct ForceRows {
+    decltype(Force::C) C;
+    decltype(Force::fmin) fmin;
+    decltype(Force::fmax) fmax;
+    decltype(Force::stiffness) stiffness;
+    decltype(Force::motor) motor;
+    decltype(Force::fracture) fracture;
+    decltype(Force::penalty) penalty;
+    decltype(Force::lambda) lambda;
+    decltype(Force::inIsland) inIsland;
+};
+
+// reads through a whole snapshot without changing the solver, so loadSnapshot only starts applying
+// it once nothing can fail. Every index is checked against the counts in the snapshot
+bool Solver::checkSnapshot(const uint8_t* data, size_t size) {
+    ByteReader in(data, size);
+    bool ok = true;
+    auto skip = [&in, &ok](const auto& field) {
+        std::remove_const_t<std::remove_reference_t<decltype(field)>> value;
+        ok &= in.read(value);
+    };
+    auto inRange = [](int32_t i, uint32_t count) { return i >= -1 && i < (int32_t) count; };
+
+    uint32_t magic = 0, version = 0, bodyCount = 0, forceCount = 0;
+    if (!in.read(magic) || !in.read(version) || !in.read(bodyCount) || !in.read(forceCount)) return false;
+    if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION || bodyCount != bodies.size()) return false;
+    if (forceCount > in.remaining()) return false; // every force takes more than a byte, bounds the scratch arrays
+
+    FrameArena& arena = frameArena();
+    FrameArena::Scope scope(arena);
+
+    // body table, every body exactly once
+    ArenaVector<Rigid*> order(bodyCount, nullptr, arena);
+    ArenaVector<BodyHandle> bodyHandle(bodyCount, BodyHandle(), arena);
+    ArenaVector<char> seen(bodyCount, 0, arena);
+    for (uint32_t i = 0; i < bodyCount; i++) {
+        int id = -1;
+        if (!in.read(bodyHandle[i]) || !in.read(id)) return false;
+        Rigid* body = get(bodyHandle[i]);
+        if (body == nullptr || body->id != id || seen[body->index]) return false;
+        seen[body->index] = 1;
+        order[i] = body;
+    }
+
+    // island parents must lead to a root, islandRoot would loop forever on a cycle
+    ArenaVector<int32_t> parent(bodyCount, -1, arena);
+    for (uint32_t i = 0; i < bodyCount; i++) {
+        bodyFields(order[i], skip);
+        ok &= in.read(parent[i]);
+        if (!ok || parent[i] < 0 || parent[i] >= (int32_t) bodyCount) return false;
+    }
+    ArenaVector<char> rooted(bodyCount, 0, arena); // 1 while on the walked path, 2 once known to reach a root
+    for (uint32_t i = 0; i < bodyCount; i++) {
+        int32_t j = i;
+        while (!rooted[j] && parent[j] != j) {
+            rooted[j] = 1;
+            j = parent[j];
+        }
+        if (rooted[j] == 1) return false;
+        rooted[j] = 2;
+        for (int32_t k = i; rooted[k] == 1; k = parent[k]) rooted[k] = 2;
+    }
+
+    // force table, forces that still exist must act on the same bodies, the rest must be contacts
+    ArenaVector<Force*> restored(forceCount, nullptr, arena);
+    ArenaVector<ForceHandle> forceHandle(forceCount, ForceHandle(), arena);
+    ArenaVector<int32_t> forceA(forceCount, -1, arena), forceB(forceCount, -1, arena);
+    ArenaVector<char> kept(forces.size(), 0, arena);
+    for (uint32_t i = 0; i < forceCount; i++) {
+        int id = -1;
+        uint8_t contact = 0;
+        int32_t& bodyA = forceA[i];
+        int32_t& bodyB = forceB[i];
+        if (!in.read(forceHandle[i]) || !in.read(id) || !in.read(contact) || !in.read(bodyA) || !in.read(bodyB)) return false;
+        if (!inRange(bodyA, bodyCount) || !inRange(bodyB, bodyCount)) return false;
+        if (bodyA >= 0 && bodyA == bodyB) return false;
+
+        Force* force = get(forceHandle[i]);
+        if (force && force->id == id) {
+            if (kept[force->index]) return false;
+            if (force->bodyA != (bodyA >= 0 ? order[bodyA] : nullptr)) return false;
+            if (force->bodyB != (bodyB >= 0 ? order[bodyB] : nullptr)) return false;
+            kept[force->index] = 1;
+            restored[i] = force;
+        }
+        else if (!contact || bodyA < 0 || bodyB < 0) return false;
+    }
+    for (Force* force : restored) {
+        ForceRows rows;
+        forceFields(&rows, skip);
+        if (!ok) return false;
+        if (force ? !force->check(in) : !Manifold::checkState(in)) return false;
+    }
+
+    // links, the chain of every body lists each force on it exactly once
+    ArenaVector<int32_t> head(bodyCount, -1, arena), nextA(forceCount, -1, arena), nextB(forceCount, -1, arena);
+    for (int32_t& link : head) if (!in.read(link) || !inRange(link, forceCount)) return false;
+    for (uint32_t i = 0; i < forceCount; i++) {
+        if (!in.read(nextA[i]) || !inRange(nextA[i], forceCount)) return false;
+        if (!in.read(nextB[i]) || !inRange(nextB[i], forceCount)) return false;
+    }
+    ArenaVector<char> onA(forceCount, 0, arena), onB(forceCount, 0, arena);
+    for (int32_t b = 0; b < (int32_t) bodyCount; b++) {
+        for (int32_t f = head[b]; f >= 0;) {
+            bool a = forceA[f] == b;
+            if (!a && forceB[f] != b) return false;
+            char& linked = a ? onA[f] : onB[f];
+            if (linked) return false;
+            linked = 1;
+            f = a ? nextA[f] : nextB[f];
+        }
+    }
+    for (uint32_t i = 0; i < forceCount; i++)
+        if (onA[i] != (forceA[i] >= 0) || onB[i] != (forceB[i] >= 0)) return false;
+
+    if (!bodyHandles.check(in, bodyCount, [&](int32_t i) { return bodyHandle[i]; }, arena)) return false;
+    if (!forceHandles.check(in, forceCount, [&](int32_t i) { return forceHandle[i]; }, arena)) return false;
+
+    uint32_t islandCount = 0;
+    if (!in.read(islandCount)) return false;
+    for (uint32_t i = 0; i < islandCount; i++) {
+        Island island;
+        skip(island.sleeping);
+        skip(island.iterations);
+        skip(island.primalResidual);
+        skip(island.dualResidual);
+        skip(island.timedOut);
+
+        uint32_t counts[2] = { bodyCount, forceCount };
+        for (uint32_t limit : counts) {
+            uint32_t count = 0;
+            if (!ok || !in.read(count)) return false;
+            for (uint32_t j = 0; j < count; j++) {
+                int32_t index = -1;
+                if (!in.read(index) || index < 0 || index >= (int32_t) limit) return false;
+            }
+        }
+    }
+
+    solverFields(this, skip);
+    return ok;
+}
+
+// Bodies are matched through their handles and must be the same set as when the snapshot was taken.
+// Forces that are missing are recreated if they are contacts, forces that didn't exist yet are
+// destroyed. The whole buffer is checked first, so a snapshot that doesn't fit this solver or is
+// cut short or corrupt changes nothing and returns false.
+bool Solver::loadSnapshot(const uint8_t* data, size_t size) {
+    if (!checkSnapshot(data, size)) return false;
+
+    // every read below succeeds and every index is in range, see checkSnapshot
+    ByteReader in(data, size);
+    auto read = [&in](auto& value) { in.read(value); };
+    auto skip = [&in](const auto& field) {
+        std::remove_const_t<std::remove_reference_t<decltype(field)>> value;
+        in.read(value);
+    };
+
+    uint32_t magic = 0, version = 0, bodyCount = 0, forceCount = 0;
+    read(magic);
+    read(version);
+    read(bodyCount);
+    read(forceCount);
+
+    FrameArena& arena = frameArena();
+    FrameArena::Scope scope(arena);
+
+    for (uint32_t i = 0; i < bodyCount; i++) {
+        BodyHandle handle;
+        int id = -1;
+        read(handle);
+        read(id);
+        Rigid* body = get(handle);
+        bodies[i] = body;
+        body->index = i;
+    }
+
+    // body state is applied once the stale forces are gone, destroying them wakes their bodies
+    ByteReader bodyState = in;
+    for (Rigid* body : bodies) {
+        int32_t parent = -1;
+        bodyFields(body, skip);
+        read(parent);
+    }
+
+    // force table, matched forces are kept as they are so contacts are only recreated when needed
+    struct Entry {
+        ForceHandle handle;
+        int id = -1;
+        uint8_t contact = 0;
+        int32_t bodyA = -1, bodyB = -1;
+    };
+    ArenaVector<Entry> entries(forceCount, Entry(), arena);
+    ArenaVector<Force*> restored(forceCount, nullptr, arena);
+    ArenaVector<char> keep(forces.size(), 0, arena);
+    for (uint32_t i = 0; i < forceCount; i++) {
+        Entry& e = entries[i];
+        read(e.handle);
+        read(e.id);
+        read(e.contact);
+        read(e.bodyA);
+        read(e.bodyB);
+
+        Force* force = get(e.handle);
+        if (force && force->id == e.id) {
+            restored[i] = force;
+            keep[force->index] = 1;
+        }
+    }
+
+    ArenaVector<Force*> stale(arena);
+    for (Force* force : forces) if (!keep[force->index]) stale.push_back(force);
+    for (Force* force : stale) force->destroy();
+
+    for (uint32_t i = 0; i < forceCount; i++)
+        if (restored[i] == nullptr) restored[i] = manifoldPool.create(this, bodies[entries[i].bodyA], bodies[entries[i].bodyB]);
+
+    for (Rigid* body : bodies) {
+        int32_t parent = -1;
+        bodyFields(body, [&bodyState](auto& value) { bodyState.read(value); });
+        bodyState.read(parent);
+        body->islandParent = bodies[parent];
+    }
+
+    forces.assign(restored.begin(), restored.end());
+    for (uint32_t i = 0; i < forceCount; i++) {
+        Force* force = forces[i];
+        force->index = i;
+        force->id = entries[i].id;
+        force->handle = entries[i].handle;
+        forceFields(force, read);
+        force->load(in);
+    }
+
+    // links
+    auto body = [this](int32_t i) { return i >= 0 ? bodies[i] : nullptr; };
+    auto force = [this](int32_t i) { return i >= 0 ? forces[i] : nullptr; };
+    for (Rigid* b : bodies) {
+        int32_t head = -1;
+        read(head);
+        b->forces = force(head);
+    }
+    for (Force* f : forces) {
+        int32_t nextA = -1, nextB = -1;
+        read(nextA);
+        read(nextB);
+        f->nextA = force(nextA);
+        f->nextB = force(nextB);
+    }
+
+    bodyHandles.load(in, body);
+    forceHandles.load(in, force);
+
+    uint32_t islandCount = 0;
+    read(islandCount);
+    islands.resize(islandCount);
+    for (Island& island : islands) {
+        uint32_t count = 0;
+        read(island.sleeping);
+        read(island.iterations);
+        read(island.primalResidual);
+        read(island.dualResidual);
+        read(island.timedOut);
+
+        read(count);
+        island.bodies.resize(count);
+        for (Rigid*& b : island.bodies) {
+            int32_t i = -1;
+            read(i);
+            b = bodies[i];
+        }
+
+        read(count);
+        island.forces.resize(count);
+        for (Force*& f : island.forces) {
+            int32_t i = -1;
+            read(i);
+            f = forces[i];
+        }
+    }
+
+    solverFields(this, read);
+    return true;
+}
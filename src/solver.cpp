@@ -1,6 +1,9 @@
 #include "solver.h"
 
-Solver::Solver() : bodies(nullptr), forces(nullptr) {
+Solver::Solver() : Solver(std::make_shared<ThreadPool>(std::max(1u, std::thread::hardware_concurrency()))) {}
+
+Solver::Solver(std::shared_ptr<ThreadPool> pool) : accumulator(0.0f), interpolation(0.0f), meshes(nullptr), nextBodyId(0), nextForceId(0), stepHash(0), stepsSinceReorder(0), islandsDirty(true), pool(std::move(pool)), stepIterations(0), stepPrimalResidual(0.0f), stepDualResidual(0.0f), stepTimedOut(false), stepArenaBytes(0) {
+    arenas.resize(this->pool->size() + 1);
     defaultParams();
 }
 
@@ -9,8 +12,37 @@ Solver::~Solver() {
 }
 
 void Solver::clear() {
-    // delete[] forces;
-    delete[] bodies;
+    // forces first so bodies don't wake islands through them
+    while (!forces.empty()) forces.back()->destroy();
+    while (!bodies.empty()) delete bodies.back();
+}
+
+void Solver::destroy(BodyHandle handle) {
+    delete get(handle);
+}
+
+void Solver::destroy(ForceHandle handle) {
+    if (Force* force = get(handle)) force->destroy();
+}
+
+// every removal is O(1) apart from walking the force chains of the bodies involved, handles
+// that are stale or repeated in the list are skipped
+void Solver::destroyBodies(const BodyHandle* handles, int count) {
+    for (int i = 0; i < count; i++) destroy(handles[i]);
+}
+
+void Solver::destroyForces(const ForceHandle* handles, int count) {
+    for (int i = 0; i < count; i++) destroy(handles[i]);
+}
+
+FrameArena& Solver::frameArena() {
+    return arenas[pool->workerIndex() + 1];
+}
+
+size_t Solver::arenaHighWater() const {
+    size_t highWater = 0;
+    for (const FrameArena& arena : arenas) highWater = std::max(highWater, arena.highWaterMark());
+    return highWater;
 }  
 
 void Solver::defaultParams()
@@ -18,6 +50,13 @@ void Solver::defaultParams()
     gravity = vec3(0, -10.0f, 0);
     iterations = 10;
 
+    // Islands stop iterating early once the largest body update and the largest error of any
+    // constraint row inside its force bounds both fall below these tolerances, but never before
+    // minIterations. A tolerance of 0 disables the check so every step runs all iterations.
+    minIterations = 2;
+    primalTolerance = 0.0f;
+    dualTolerance = 0.0f;
+
     // Note: in the paper, beta is suggested to be [1, 1000]. Technically, the best choice will
     // depend on the length, mass, and constraint function scales (ie units) of your simulation,
     // along with your strategy for incrementing the penalty parameters.
@@ -33,60 +72,156 @@ void Solver::defaultParams()
     // This should always be < 1 so that the penalty values can decrease (unless you use a different
     // penalty parameter strategy which does not require decay).
     gamma = 0.99f;
+
+    // When enabled, constraint errors are evaluated once after each body update for the forces
+    // acting on that body, and the cached values are reused by the other body and the dual update
+    // instead of being recomputed three times per force per iteration.
+    cacheConstraints = true;
+
+    // Body inertia is rotated into world space once per step at the warmstarted rotation. Rotation
+    // only changes slightly within a step, but this can be enabled to follow it every iteration.
+    refreshInertia = false;
+
+    // Consecutive bodies that share no force are independent within a sweep, so their systems are
+    // gathered and solved SIMD_LANES at a time. This matches solving them one by one up to rounding.
+    batchSolve = true;
+
+    // Linalg types only check for NaN per operation when built with LINALG_VALIDATION. This cheaper
+    // check runs over body state once at the end of every step instead.
+    validate = false;
+
+    // Islands are groups of dynamic bodies connected through forces. They never interact during the
+    // iterations, so each one is solved as its own task on the thread pool.
+    parallelIslands = true;
+
+    // advance runs the simulation in fixed steps of timestep seconds regardless of frame rate. Each
+    // is split into substeps solver steps, and AVBD generally converges better with more substeps
+    // and fewer iterations for the same cost. After maxSteps fixed steps in one call, the rest of
+    // the frame time is dropped so a slow frame can't make every following frame slower.
+    timestep = 1.0f / 60.0f;
+    substeps = 1;
+    maxSteps = 4;
+
+    // Jacobi sweeps solve every body of an island against the poses from the previous sweep, so
+    // all bodies run in parallel on the thread pool without any ordering. Neighbours no longer see
+    // each other's updates within a sweep, so only a fraction of each update is applied to keep
+    // stacks from overshooting. Several islands are still solved as separate tasks, each sweeping
+    // its bodies on its own worker, while a lone island spreads its bodies over the pool.
+    jacobi = false;
+    relaxation = 0.5f;
+
+    // Deterministic mode keeps bodies, forces and the force chains of every body sorted by creation
+    // order, so a replay gives bit-identical results no matter how lists were reordered by removals
+    // or how many threads the pool has. Deadlines are ignored since they depend on wall-clock time.
+    // The state hash after every step can be compared between peers to catch divergence early.
+    deterministic = false;
+
+    // Chebyshev semi-iterative acceleration from Vertex Block Descent. After each sweep, body poses
+    // are pushed further along the direction of the last two iterations, with a weight derived from
+    // spectralRadius. Higher values extrapolate more aggressively. If a sweep moves bodies more
+    // than the one before, the island is treated as diverging and restarts from a plain sweep.
+    // The dual update changes the problem between sweeps, so gains are smaller than for VBD, see
+    // benchmarkConvergence.
+    accelerate = false;
+    spectralRadius = 0.7f;
+
+    // Every reorderInterval steps, bodies are sorted by the Morton code of their position and moved
+    // into one block in that order, and forces are sorted by their first body, see reorderBodies.
+    // Neighbouring bodies then sit next to each other in memory and follow each other in the sweeps,
+    // instead of being scattered over the heap in creation order. Rigid pointers held outside the
+    // solver go stale when this runs, handles don't. Deterministic mode keeps creation order, so no
+    // reordering happens there.
+    reorderInterval = 0;
+
+    // Geometric stiffness adds the curvature of each constraint, scaled by the magnitude of its
+    // force, to the primal systems (Eq. 17). Only the lumped diagonal is used, which keeps the
+    // systems positive definite, and forces compute it directly instead of forming the full
+    // hessian. It mostly matters for stiff joints under large forces; contacts are nearly linear.
+    geometricStiffness = false;
+
+    // Islands whose bodies all stay below the velocity thresholds for sleepTime seconds are put to
+    // sleep and skipped by every pass until an awake body touches them or a support is removed.
+    allowSleep = true;
+    sleepLinearVelocity = 0.05f;
+    sleepAngularVelocity = 0.1f;
+    sleepTime = 0.5f;
 }
 
-void Solver::step(float dt) {
+// islands always finish the sweep they are on and velocities are always updated, so a deadline only
+// trades accuracy for time and the step may still end slightly after it
+void Solver::step(float dt, std::chrono::steady_clock::time_point deadline) {
+    this->deadline = deterministic ? std::chrono::steady_clock::time_point::max() : deadline;
 
     if (dt < 1e-5f) dt = 1e-5f; // TODO remove this, maybe causing division by 0 errors. 
 
+    // scratch data of the previous step is no longer referenced
+    for (FrameArena& arena : arenas) arena.reset();
+
+    // buildIslands lists the forces again, so contacts dropped before then have nothing to leave
+    for (Island& island : islands) island.forces.clear();
+
+    // broadphase pairs and new manifolds follow body order
+    if (deterministic) sortBodies();
+    else if (reorderInterval > 0 && ++stepsSinceReorder >= reorderInterval) {
+        reorderBodies();
+        stepsSinceReorder = 0;
+    }
+
     if (DEBUG_PRINT) print("Starting Solver Step");
 
     // broadphase collision, simple spherical distance checks
-    for (Rigid* bodyA = bodies; bodyA != nullptr; bodyA = bodyA->next) 
-        for (Rigid* bodyB = bodyA->next; bodyB != nullptr; bodyB = bodyB->next) {
-            vec3 dp = bodyA->position - bodyB->position;
+    for (size_t a = 0; a < bodies.size(); a++)
+        for (size_t b = a + 1; b < bodies.size(); b++) {
+            Rigid* bodyA = bodies[a];
+            Rigid* bodyB = bodies[b];
+
+            // sleeping and static bodies only collide with awake ones
+            if (!bodyA->awake() && !bodyB->awake()) continue;
+
+            vec3 dp = vec3(bodyA->position - bodyB->position);
             float r = bodyA->radius + bodyB->radius;
             if (glm::dot(dp, dp) <= r * r && !bodyA->constrainedTo(bodyB))
-                new Manifold(this, bodyA, bodyB); // handles narrowphase collision internally
+                manifoldPool.create(this, bodyA, bodyB); // handles narrowphase collision internally
         }
 
-    if (DEBUG_PRINT) print("Warmstart Forces");
+    if (deterministic) sortForces();
 
-    // initialize and warmstart forces
-    for (Force* force = forces; force != nullptr;) {
-        // initialization can include caching anything that is constant over the step
-        if (!force->initialize()) {
-            // force has returned false meaning it is inactive, so remove it from the solver
-            Force* next = force->next;
-            delete force;
-            force = next; 
-        } else {
-            for (int i = 0; i < force->rows(); i++) {
-                // warmstart the dual variables and penalty parameters (Eq. 19)
-                // penalty is safely clamped to a minimum and maximum value
-                force->lambda[i] = force->lambda[i] * alpha * gamma;
-                force->penalty[i] = glm::clamp(force->penalty[i] * gamma, PENALTY_MIN, PENALTY_MAX);
+    if (DEBUG_PRINT) print("Warmstart Forces");
 
-                // if it's not a hard constraint, we don't let the penalty exceed material stiffness
-                force->penalty[i] = glm::min(force->penalty[i], force->stiffness[i]);
-            }
-            force = force->next;
+    // initialize and warmstart forces, forces without an awake body stay frozen
+    ArenaVector<Force*> frozen(frameArena());
+    for (size_t i = 0; i < forces.size();) {
+        Force* force = forces[i];
+        if (!force->active()) frozen.push_back(force);
+        else if (!warmstartForce(force)) {
+            force->destroy(); // force is inactive, so remove it from the solver
+            continue; // the last force was swapped into this slot
         }
+        i++;
     }
 
+    // islands woken above need their forces warmstarted as well
+    for (Force* force : frozen)
+        if (force->active() && !warmstartForce(force)) force->destroy();
+
+    // the force set is final for this step, so the solve can walk flat per-body force lists
+    buildAdjacency();
+
     if (DEBUG_PRINT) print("Warmstart Bodies");
 
     // initialize and warmstart bodies (i.e. primal variables)
-    for (Rigid* body = bodies; body != nullptr; body = body->next) {
+    for (Rigid* body : bodies) {
+        if (body->sleeping) continue;
+
         // compute inertial state
-        body->inertialPosition = body->position + body->velocity.linear * dt;
+        body->inertialPosition = body->position + pvec3(body->velocity.linear) * (scalar) dt;
         if (body->mass > 0) body->inertialPosition += gravity * (dt * dt);
 
         quat angVel = quat(0, body->velocity.angular);
         body->inertialRotation = glm::normalize(body->rotation + (0.5f * dt) * angVel * body->rotation);
 
         // adaptive warmstarting
-        vec3 accel = (body->velocity.linear - body->prevVelocity.linear) / dt;
+        vec3 accel = vec3(body->velocity.linear - body->prevVelocity.linear) / dt;
         float accelExt = dot(accel, normalize(gravity));
         float accelWeight = glm::clamp(accelExt / length(gravity), 0.0f, 1.0f);
         if (!std::isfinite(accelWeight)) accelWeight = 0.0f;
@@ -95,55 +230,338 @@ void Solver::step(float dt) {
         body->initialPosition = body->position;
         body->initialRotation = body->rotation;
 
-        body->position += body->velocity.linear * dt + gravity * (accelWeight * dt * dt);
+        body->position += pvec3(body->velocity.linear) * (scalar) dt + pvec3(gravity * (accelWeight * dt * dt));
         body->rotation = body->inertialRotation;
+
+        // cache world inertia and mass matrix for the step
+        if (body->mass > 0) body->updateInertia(dt);
+
+        body->iteratePosition[0] = body->position;
+        body->iterateRotation[0] = body->rotation;
     }
 
+    if (DEBUG_PRINT) print("Build Islands");
+
+    buildIslands();
+
     if (DEBUG_PRINT) print("Main Loop");
 
+    // islands share no dynamic bodies or forces, so they can be solved in any order or at the same time
+    if (parallelIslands && islands.size() > 1) {
+        // waits for this solver's islands only, forks may be stepping on the same pool
+        TaskGroup group;
+        for (Island& island : islands)
+            if (!island.sleeping) pool->enqueue(group, [this, &island, dt] { solveIsland(island, dt); });
+        pool->wait(group);
+    } else {
+        for (Island& island : islands)
+            if (!island.sleeping) solveIsland(island, dt);
+    }
+
+    // report the worst island
+    stepIterations = 0;
+    stepPrimalResidual = 0.0f;
+    stepDualResidual = 0.0f;
+    stepTimedOut = false;
+    for (const Island& island : islands) {
+        if (island.sleeping) continue;
+        stepIterations = std::max(stepIterations, island.iterations);
+        stepPrimalResidual = std::max(stepPrimalResidual, island.primalResidual);
+        stepDualResidual = std::max(stepDualResidual, island.dualResidual);
+        stepTimedOut |= island.timedOut;
+    }
+
+    if (DEBUG_PRINT) print("Compute Velocities");
+
+    // compute velocities (BDF1)
+    for (Rigid* body : bodies) {
+        if (body->sleeping) continue;
+        body->prevVelocity = body->velocity;
+        if (body->mass > 0)
+            body->velocity = vec6{ body->position - body->initialPosition, body->deltaWInitial() } / dt;
+    }
+
+    if (allowSleep) updateSleep(dt);
+
+    if (validate) validateBodies();
+
+    // TEMP respawn fallen blocks to the origin
+    for (Rigid* body : bodies) {
+        if (glm::length2(body->position) > 1.0e5f) {
+            body->position = {0, 2.0, 0};
+            body->velocity.linear = {0, 0, 0};
+        }
+    }
+
+    if (deterministic) stepHash = hashState();
+
+    stepArenaBytes = 0;
+    for (const FrameArena& arena : arenas) stepArenaBytes += arena.bytesUsed();
+}
+
+// advances the simulation by frame time in fixed steps, returns the number of fixed steps taken
+// steps past the deadline still run, but with a single iteration each
+int Solver::advance(float frameTime, std::chrono::steady_clock::time_point deadline) {
+    accumulator += glm::max(frameTime, 0.0f);
+
+    int steps = 0;
+    while (accumulator >= timestep && steps < maxSteps) {
+        // keep the start of the step so rendering can interpolate towards the end of it
+        for (Rigid* body : bodies) {
+            body->prevPosition = body->position;
+            body->prevRotation = body->rotation;
+        }
+
+        for (int i = 0; i < substeps; i++) step(timestep / substeps, deadline);
+
+        accumulator -= timestep;
+        steps++;
+    }
+
+    // drop whole steps we could not catch up on
+    if (accumulator >= timestep) accumulator = fmod(accumulator, timestep);
+
+    interpolation = accumulator / timestep;
+    return steps;
+}
+
+// initializes a force and warmstarts its dual variables, returns false if the force is no longer active
+bool Solver::warmstartForce(Force* force) {
+    // initialization can include caching anything that is constant over the step
+    if (!force->initialize()) return false;
+
+    // touching a sleeping body wakes its island
+    wakeIsland(force->bodyA);
+    wakeIsland(force->bodyB);
+
+    // join the islands of both bodies, removals are handled by rebuilding in buildIslands
+    if (!force->inIsland && !islandsDirty) mergeIslands(force);
+
+    for (int i = 0; i < force->rows(); i++) {
+        // warmstart the dual variables and penalty parameters (Eq. 19)
+        // penalty is safely clamped to a minimum and maximum value
+        force->lambda[i] = force->lambda[i] * alpha * gamma;
+        force->penalty[i] = glm::clamp(force->penalty[i] * gamma, PENALTY_MIN, PENALTY_MAX);
+
+        // if it's not a hard constraint, we don't let the penalty exceed material stiffness
+        force->penalty[i] = glm::min(force->penalty[i], force->stiffness[i]);
+    }
+
+    return true;
+}
+
+// builds the primal linear system for a body (Eqs. 5, 6)
+void Solver::assemble(Rigid* body, float dt, mat6x6& lhs, vec6& rhs) {
+    // follow the rotation from the previous iteration if requested
+    if (refreshInertia) body->updateInertia(dt);
+
+    // initialize left and right hand sides of the linear system
+    lhs = body->scaledMass;
+    rhs = lhs * vec6{ body->position - body->inertialPosition, body->deltaWInertial() };
+
+    // derivatives are written here rather than to the force, so both of its bodies can be assembled at once
+    vec6 J[MAX_ROWS];
+    vec6 H[MAX_ROWS];
+
+    // iterate over all acting on the body
+    for (int k = adjacencyStart[body->index]; k < adjacencyStart[body->index + 1]; k++) {
+        Force* force = adjacency[k];
+
+        // compute constraint and its derivatives, jacobi sweeps evaluate all constraints up front
+        if (!cacheConstraints && !jacobi) force->computeConstraint(alpha);
+        force->computeDerivatives(body, J, geometricStiffness ? H : nullptr);
+
+        for (int i = 0; i < force->rows(); i++) {
+            // use lambda as 0 if it's not a hard constraint
+            float lambda = std::isinf(force->stiffness[i]) ? force->lambda[i] : 0.0f;
+
+            // compute the clamped force magnitude (sec 3.2)
+            float f = glm::clamp(force->penalty[i] * force->C[i] + lambda + force->motor[i], force->fmin[i], force->fmax[i]);
+
+            // accumulate force (eq. 13) and hessian (eq. 17)
+            rhs += J[i] * f;
+            lhs += outer(J[i], J[i] * force->penalty[i]);
+            if (geometricStiffness) lhs.addDiagonal(H[i] * std::abs(f));
+        }
+    }
+}
+
+// applies a primal solution to a body (Eq. 4), returns the largest component of the update
+float Solver::applyDelta(Rigid* body, const vec6& delta) {
+    body->displace(delta);
+
+    // refresh only the constraints touching the body that just moved
+    if (cacheConstraints)
+        for (int k = adjacencyStart[body->index]; k < adjacencyStart[body->index + 1]; k++)
+            adjacency[k]->computeConstraint(alpha);
+
+    return (float) maxAbs(delta);
+}
+
+// solves every body of the island against the current poses and applies the relaxed updates
+// afterwards, returns the largest applied update. Bodies are spread over the pool unless the island
+// already runs as one of several pool tasks, then the other islands keep the workers busy
+float Solver::jacobiSweep(const Island& island, float dt, ArenaVector<vec6>& deltas) {
+    int count = (int) island.bodies.size();
+    deltas.resize(count);
+
+    bool nested = pool->workerIndex() >= 0;
+    auto forRanges = [&](int n, auto&& f) {
+        if (nested) f(0, n);
+        else pool->parallelFor(n, f);
+    };
+
+    // errors at the poses every body solves against
+    if (!cacheConstraints)
+        forRanges((int) island.forces.size(), [&](int begin, int end) {
+            for (int i = begin; i < end; i++) island.forces[i]->computeConstraint(alpha);
+        });
+
+    // bodies only read each other's state here, so no two ranges conflict
+    forRanges(count, [&](int begin, int end) {
+        SystemBatch batch;
+        for (int i = begin; i < end; i++) {
+            mat6x6 lhs;
+            vec6 rhs;
+            assemble(island.bodies[i], dt, lhs, rhs);
+
+            if (!batchSolve) {
+                deltas[i] = solveBlock(lhs, rhs);
+                continue;
+            }
+
+            // every body is independent, so the batch fills without any connectivity check
+            batch.add(lhs, rhs);
+            if (batch.size == SIMD_LANES || i + 1 == end) {
+                solve(batch);
+                for (int j = 0; j < batch.size; j++) deltas[i + 1 - batch.size + j] = batch.solution(j);
+                batch.clear();
+            }
+        }
+    });
+
+    float residual = 0.0f;
+    for (int i = 0; i < count; i++) {
+        vec6 delta = deltas[i] * relaxation;
+        island.bodies[i]->displace(delta);
+        residual = glm::max(residual, (float) maxAbs(delta));
+    }
+
+    // every force may have moved, so refresh them all at once instead of per body
+    if (cacheConstraints)
+        forRanges((int) island.forces.size(), [&](int begin, int end) {
+            for (int i = begin; i < end; i++) island.forces[i]->computeConstraint(alpha);
+        });
+
+    return residual;
+}
+
+// moves each body to omega * (x - x_{k-2}) + x_{k-2} and shifts its iterate history
+void Solver::extrapolate(const Island& island, float omega) {
+    for (Rigid* body : island.bodies) {
+        if (omega != 1.0f) {
+            body->position = (scalar) omega * (body->position - body->iteratePosition[1]) + body->iteratePosition[1];
+            body->rotation = glm::normalize(omega * (body->rotation - body->iterateRotation[1]) + body->iterateRotation[1]);
+        }
+
+        body->iteratePosition[1] = body->iteratePosition[0];
+        body->iterateRotation[1] = body->iterateRotation[0];
+        body->iteratePosition[0] = body->position;
+        body->iterateRotation[0] = body->rotation;
+    }
+
+    // cached errors were computed before the bodies moved
+    if (omega != 1.0f && cacheConstraints)
+        for (Force* force : island.forces)
+            force->computeConstraint(alpha);
+}
+
+// solves every system gathered in the batch and applies the updates, returns the largest update
+float Solver::flushBatch(SystemBatch& batch, Rigid** batched) {
+    if (batch.size == 0) return 0.0f;
+
+    solve(batch);
+    float residual = 0.0f;
+    for (int i = 0; i < batch.size; i++) residual = glm::max(residual, applyDelta(batched[i], batch.solution(i)));
+    batch.clear();
+    return residual;
+}
+
+// throws if any body has NaN in its state
+void Solver::validateBodies() const {
+    for (Rigid* body : bodies) {
+        if (hasNaN(body->position)) throw std::runtime_error("Solver::validateBodies position has NaN");
+        if (hasNaN(body->rotation)) throw std::runtime_error("Solver::validateBodies rotation has NaN");
+        if (hasNaN(body->velocity.linear) || hasNaN(body->velocity.angular)) throw std::runtime_error("Solver::validateBodies velocity has NaN");
+    }
+}
+
+// runs every primal and dual iteration over a single island
+void Solver::solveIsland(Island& island, float dt) {
+    // evaluate all constraints once at the warmstarted positions
+    if (cacheConstraints)
+        for (Force* force : island.forces)
+            force->computeConstraint(alpha);
+
+    island.timedOut = false;
+
+    // Chebyshev weight and the sweeps since it was last reset
+    float omega = 1.0f;
+    int accelerated = 0;
+    float lastPrimalResidual = INFINITY;
+
+    ArenaVector<vec6> deltas(frameArena());
+
     // main solver loop
     for (int it = 0; it < iterations; it++) {
+        island.iterations = it + 1;
+        float primalResidual = 0.0f;
+        float dualResidual = 0.0f;
+
         // primal update
-        for (Rigid* body = bodies; body != nullptr; body = body->next) {
-            // skip static bodies
-            if (body->mass <= 0) continue;
-
-            // initialize left and right hand sides of the linear system (Eqs. 5, 6)
-            mat6x6 M = body->getMassMatrix();
-            mat6x6 lhs = M / (dt * dt);
-            vec6 rhs = lhs * vec6{ body->position - body->inertialPosition, body->deltaWInertial() };
-
-            // iterate over all acting on the body
-            for (Force* force = body->forces; force != nullptr; force = (force->bodyA == body) ? force->nextA : force->nextB) {
-                // compute constraint and its derivatives
-                force->computeConstraint(alpha);
-                force->computeDerivatives(body);
-
-                for (int i = 0; i < force->rows(); i++) {
-                    // use lambda as 0 if it's not a hard constraint
-                    float lambda = std::isinf(force->stiffness[i]) ? force->lambda[i] : 0.0f;
-
-                    // compute the clamped force magnitude (sec 3.2)
-                    float f = glm::clamp(force->penalty[i] * force->C[i] + lambda + force->motor[i], force->fmin[i], force->fmax[i]);
-
-                    // accumulate force (eq. 13) and hessian (eq. 17)
-                    rhs += force->J[i] * f;
-                    lhs += outer(force->J[i], force->J[i] * force->penalty[i]); // + diagonalLump(force->H[i] * abs(f));
+        if (jacobi) {
+            primalResidual = jacobiSweep(island, dt, deltas);
+        } else {
+            SystemBatch batch;
+            Rigid* batched[SIMD_LANES];
+
+            for (Rigid* body : island.bodies) {
+                // a body connected to one already in the batch depends on its update, so solve the batch first
+                if (batchSolve && (batch.size == SIMD_LANES || connected(body, batched, batch.size)))
+                    primalResidual = glm::max(primalResidual, flushBatch(batch, batched));
+
+                mat6x6 lhs;
+                vec6 rhs;
+                assemble(body, dt, lhs, rhs);
+
+                if (batchSolve) {
+                    batched[batch.size] = body;
+                    batch.add(lhs, rhs);
+                } else {
+                    // solve the SPD linear system using its 3x3 blocks and apply the update (Eq. 4)
+                    primalResidual = glm::max(primalResidual, applyDelta(body, solveBlock(lhs, rhs)));
                 }
             }
 
-            // solve the SPD linear system using LDL and apply the update (Eq. 4)
-            vec6 delta = solve(lhs, rhs);
-            if (hasNaN(delta.linear) || hasNaN(delta.angular)) throw std::runtime_error("solution has nan");
-            body->position -= delta.linear;
-            quat dq = quat(0.0f, delta.angular);
-            body->rotation = glm::normalize(body->rotation - 0.5f * (dq * body->rotation));
+            if (batchSolve) primalResidual = glm::max(primalResidual, flushBatch(batch, batched));
+        }
+
+        // extrapolate the sweep, restarting if it moved bodies more than the last one
+        // the final sweep is kept as is so the step ends on a solved pose
+        if (accelerate && it + 1 < iterations) {
+            float rho2 = spectralRadius * spectralRadius;
+            if (primalResidual > lastPrimalResidual) accelerated = 0;
+            omega = accelerated == 0 ? 1.0f : accelerated == 1 ? 2.0f / (2.0f - rho2) : 4.0f / (4.0f - rho2 * omega);
+            lastPrimalResidual = primalResidual;
+            accelerated++;
+
+            extrapolate(island, omega);
         }
 
         // dual update
-        for (Force* force = forces; force != nullptr; force = force->next) {
-            // compute constraint
-            force->computeConstraint(alpha);
+        for (Force* force : island.forces) {
+            // compute constraint, cached values are already current after the primal update
+            if (!cacheConstraints) force->computeConstraint(alpha);
 
             for (int i = 0; i < force->rows(); i++) {
                 // Use lambda as 0 if it's not a hard constraint
@@ -157,26 +575,30 @@ void Solver::step(float dt) {
                 if (fabs(force->lambda[i]) >= force->fracture[i]) force->disable();
 
                 // Update the penalty parameter and clamp to material stiffness if we are within the force bounds (Eq. 16)
-                if (force->lambda[i] > force->fmin[i] && force->lambda[i] < force->fmax[i])
+                // rows clamped to a bound (separating contacts, sliding friction) and broken forces don't count towards the residual
+                if (force->lambda[i] > force->fmin[i] && force->lambda[i] < force->fmax[i]) {
                     force->penalty[i] = glm::min(force->penalty[i] + beta * abs(force->C[i]), glm::min(PENALTY_MAX, force->stiffness[i]));
+                    if (force->stiffness[i] > 0.0f) dualResidual = glm::max(dualResidual, abs(force->C[i]));
+                }
             }
         }
-    }
 
-    if (DEBUG_PRINT) print("Compute Velocities");
+        island.primalResidual = primalResidual;
+        island.dualResidual = dualResidual;
 
-    // compute velocities (BDF1)
-    for (Rigid* body = bodies; body != nullptr; body = body->next) {
-        body->prevVelocity = body->velocity;
-        if (body->mass > 0)
-            body->velocity = vec6{ body->position - body->initialPosition, body->deltaWInitial() } / dt;
-    }
+        // stop once the island has converged
+        bool converged = it + 1 >= minIterations && primalResidual < primalTolerance && dualResidual < dualTolerance;
+        if (converged || it + 1 == iterations) break;
 
-    // TEMP respawn fallen blocks to the origin
-    for (Rigid* body = bodies; body != nullptr; body = body->next) {
-        if (glm::length2(body->position) > 1.0e5f) {
-            body->position = {0, 2.0, 0};
-            body->velocity.linear = {0, 0, 0};
+        // out of time, keep the result of the completed sweep
+        if (std::chrono::steady_clock::now() >= deadline) {
+            island.timedOut = true;
+            break;
         }
+
+        // cached constraints are not re-evaluated before the next primal update, so refresh the lambda dependent limits
+        if (cacheConstraints)
+            for (Force* force : island.forces)
+                force->computeLimits();
     }
-}
\ No newline at end of file
+}
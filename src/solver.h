@@ -4,9 +4,18 @@
 #include "util/includes.h"
 #include "collision/face.h"
 #include "linalg/ldlt.h"
+#include "linalg/batch.h"
 #include "debug_utils/debug.h"
 #include "linalg/linalg.h"
+#include "parallel/threadPool.h"
+#include "util/objectPool.h"
+#include "util/handleTable.h"
+#include "util/frameArena.h"
+#include "util/byteStream.h"
 #include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 
 #define MAX_ROWS 12           // Max scalar rows an individual constraint can have (3D contact = 3n)
 #define PENALTY_MIN 1000.0f   // Minimum penalty parameter
@@ -21,47 +30,104 @@ struct Force;
 struct Manifold;
 struct Solver;
 struct Mesh;
-struct StackFace;
+
+using BodyHandle = Handle<Rigid>;
+using ForceHandle = Handle<Force>;
+
+// parameters of the Rigid constructor, for creating many bodies at once
+struct BodyDesc {
+    vec3 size = vec3(1.0f);
+    float density = 1.0f; // negative for static bodies
+    float friction = 0.5f;
+    pvec3 position = pvec3(0.0f);
+    quat rotation = quat(1, 0, 0, 0);
+    vec6 velocity = vec6();
+    vec4 color = vec4(0.8, 0.8, 0.8, 0.5);
+};
+
+// body pose as exchanged with caller buffers
+struct Transform {
+    pvec3 position;
+    quat rotation;
+};
 
 // contains data for a single rigid body
 struct Rigid {
     Solver* solver;
     Force* forces;
-    Rigid* next;
+    BodyHandle handle;
+    int index; // position in solver->bodies, changes when other bodies are removed
+    int id; // creation order within the solver
 
     // position and rotation stored seperately since rotation is quaternion
-    vec3 position; 
+    pvec3 position; 
     quat rotation = quat(1, 0, 0, 0); 
 
     vec6 velocity = vec6(0); // linear 3, angular 3
     vec6 prevVelocity = vec6(0);
 
-    vec3 initialPosition;
+    pvec3 initialPosition;
     quat initialRotation;
-    vec3 inertialPosition;
+    pvec3 inertialPosition;
     quat inertialRotation;
+    pvec3 prevPosition; // state at the start of the last fixed step, see Solver::advance
+    quat prevRotation;
+    pvec3 iteratePosition[2]; // previous two iterates for Chebyshev acceleration, most recent first
+    quat iterateRotation[2];
 
     vec3 scale;
     float mass;
     mat3x3 inertiaTensor;
+    mat3x3 invInertiaTensor;
     float friction;
     float radius;
 
+    // world space inertia cached by updateInertia and reused across iterations
+    mat3x3 worldInertia;
+    mat3x3 invWorldInertia;
+    mat6x6 scaledMass; // M / dt^2, the primal lhs before any forces are added
+
+    // island union-find, see island.cpp
+    Rigid* islandParent;
+    int islandRank;
+    int island;
+
+    // sleeping bodies are skipped by the solver until woken
+    bool sleeping;
+    float sleepTimer; // time spent below the sleep velocity thresholds
+
     // visual attributes
     vec4 color;
 
-    Rigid(Solver* solver, vec3 size, float density, float friction, vec3 position, quat rotation = quat(1, 0, 0, 0),
+    Rigid(Solver* solver, vec3 size, float density, float friction, pvec3 position, quat rotation = quat(1, 0, 0, 0),
           vec6 velocity = vec6(), vec4 color = vec4(0.8, 0.8, 0.8, 0.5));
+    Rigid(Solver* solver, const BodyDesc& desc);
+    Rigid(Solver* solver, const Rigid& other); // unregistered copy for Solver::clone
     ~Rigid();
 
+    // bodies carry a small header so reorderBodies can move them into shared blocks, see reorder.cpp
+    static void* operator new(size_t size);
+    static void* operator new(size_t, void* where) { return where; }
+    static void operator delete(void* body);
+
     bool constrainedTo(Rigid* other) const;
+    Rigid* islandRoot();
+    bool awake() const { return mass > 0 && !sleeping; }
+    void wake();
+    void applyImpulse(const vec3& impulse, const vec3& point);
 
     mat3x3 getInertiaTensor() const;
     mat6x6 getMassMatrix() const;
+    void updateInertia(float dt);
 
+    void displace(const vec6& delta);
     vec3 deltaWInitial() const;
     vec3 deltaWInertial() const;
 
+    // blend between the last two fixed steps for rendering
+    vec3 interpolatedPosition(float t) const;
+    quat interpolatedRotation(float t) const;
+
     // static
     static int globalID;
 };
@@ -74,10 +140,9 @@ struct Force {
 
     Force* nextA;
     Force* nextB;
-    Force* next;
-
-    std::vector<vec6> J; // Jacobian rows for bodyA (bodyB are -J)
-    std::vector<mat6x6> H; // Hassian/approx for complaint constraints
+    ForceHandle handle;
+    int index; // position in solver->forces, changes when other forces are removed
+    int id; // creation order within the solver
 
     float C[MAX_ROWS]; // Constraint error per row;
     float fmin[MAX_ROWS]; // Lower force/impulse limits
@@ -88,42 +153,56 @@ struct Force {
     float penalty[MAX_ROWS];
     float lambda[MAX_ROWS]; // Accumulated impulses (warm-start)
 
+    bool inIsland; // merged into the island union-find
+
     Force(Solver* solver, Rigid* bodyA, Rigid* bodyB);
     virtual ~Force();
 
     void disable();
+    bool active() const;
 
     virtual int rows() const = 0; // # of scalar constraint equations
     virtual bool initialize() = 0; // called once when added to solver
     virtual void computeConstraint(float alpha) = 0; // C and limits per row
-    virtual void computeDerivatives(Rigid* body) = 0; // J and H per body
+    virtual void computeLimits() {} // limits that only depend on lambda
+    virtual void computeDerivatives(Rigid* body, vec6* J, vec6* H) = 0; // J rows and, if H is not null, the lumped diagonal of each row's hessian for one body, written to the caller's buffers
+    virtual void destroy() { delete this; } // removes the force and returns it to wherever it was allocated from
+    virtual Force* clone(Solver* solver) const = 0; // unregistered copy for Solver::clone, allocated the way destroy expects
+    virtual void save(ByteWriter&) const {} // state beyond the rows shared by all forces, for snapshots
+    virtual bool check(ByteReader&) const { return true; } // reads past what save wrote without changing anything, load accepts whatever check accepts
+    virtual bool load(ByteReader&) { return true; }
 
     // static
     static int globalID;
 };
 
 struct Manifold : Force {
+    // solver data of a contact, read every iteration
     struct Contact {
-        vec3 rA;
-        vec3 rB;
-        vec3 normal; // world space contact normal A -> B
-        float depth; 
-        vec3 t1;
-        vec3 t2;
-        vec6 JAn, JBn; // normal Jacobian rows
-        vec6 JAt1, JBt1; // tangent Jacobian rows
-        vec6 JAt2, JBt2; // tangent Jacobian rows in the other direction
+        vec6 JA[3]; // Jacobian rows of body A (n, t1, t2), contiguous so one body's rows are read together
+        vec6 JB[3];
         vec3 C0; // accumulated positional error (n, t1, t2)
         bool stick; // static vs dynamic friction
-        StackFace face; // saves contact data
-        int type;
 
-        Contact() : rA(), rB(), normal(), depth(0.0), t1(), t2(), JAn(), JBn(), JAt1(), JBt1(), JAt2(), JBt2(), C0(), stick(true), face() {}
+        Contact() : JA(), JB(), C0(), stick(true) {}
+    };
+
+    // where a contact is and the EPA face it came from, only touched when contacts are rebuilt or drawn
+    struct ContactPoint {
+        vec3 rA; // body space contact points
+        vec3 rB;
+        vec3 normal; // world space contact normal A -> B
+        vec3 mink[3]; // minkowski points of the face when it was found, for drift checks
+        uint8_t indexA[3]; // mesh vertex indices of the face, meshes have fewer than 256 unique vertices
+        uint8_t indexB[3];
+        uint8_t type; // contact case from getContact, for debug drawing
+
+        ContactPoint() : rA(), rB(), normal(), mink(), indexA(), indexB(), type(0) {}
 
         // only considers face indices
-        bool operator==(const Contact& rhs) {
+        bool operator==(const ContactPoint& rhs) const {
             for (int i = 0; i < 3; i++) 
-                if (face.sps[i].indexA != rhs.face.sps[i].indexA || face.sps[i].indexB != rhs.face.sps[i].indexB)
+                if (indexA[i] != rhs.indexA[i] || indexB[i] != rhs.indexB[i])
                     return false;
             return true;
         }
@@ -135,37 +214,185 @@ struct Manifold : Force {
     // friction variables, later change to mus and mud
     float friction;
 
+    ContactPoint points[4]; // cold data after everything the solver streams
+
     Manifold(Solver* solver, Rigid* bodyA, Rigid* bodyB);
 
     int rows() const override { return numContacts * 3; }
     bool initialize() override;
     void computeConstraint(float alpha) override;
-    void computeDerivatives(Rigid* body) override;
-    bool isContactStillValid(const Contact& oldContact, Rigid* bodyA, Rigid* bodyB);
+    void computeLimits() override;
+    void computeDerivatives(Rigid* body, vec6* J, vec6* H) override;
+    bool isContactStillValid(const Contact& oldContact, const ContactPoint& oldPoint, Rigid* bodyA, Rigid* bodyB);
+    void destroy() override;
+    Force* clone(Solver* solver) const override;
+    void save(ByteWriter& out) const override;
+    bool check(ByteReader& in) const override;
+    bool load(ByteReader& in) override;
+    static bool checkState(ByteReader& in); // check for contacts that don't exist yet
+
+    static int collide(Rigid* bodyA, Rigid* bodyB, ContactPoint* points);
+};
 
-    static int collide(Rigid* bodyA, Rigid* bodyB, Contact* contacts);
+// connected group of dynamic bodies and the forces acting on them, solved independently of other islands
+struct Island {
+    std::vector<Rigid*> bodies;
+    std::vector<Force*> forces;
+    bool sleeping;
+
+    // convergence of the last solve
+    int iterations;
+    float primalResidual; // largest body update in the final sweep
+    float dualResidual; // largest constraint error over rows inside their force bounds
+    bool timedOut; // stopped by the step deadline before converging
 };
 
 struct Solver {
     vec3 gravity;
-    int iterations;
+    int iterations; // upper bound on iterations per step
+    int minIterations; // iterations run before the residuals are checked
+    float primalTolerance; // islands stop iterating once both residuals are below their tolerance
+    float dualTolerance;
 
     float alpha; 
     float beta;
     float gamma;
 
-    Rigid* bodies;
-    Force* forces;
+    bool cacheConstraints; // refresh C only when a body moves and reuse it in the dual update
+    bool refreshInertia; // recompute cached body inertia every iteration instead of once per step
+    bool batchSolve; // solve independent bodies together with the SIMD batch solver
+    bool validate; // check body state for NaN once per step
+    bool parallelIslands; // solve islands as separate tasks on the thread pool
+    bool jacobi; // solve every body against the previous iterate in parallel instead of Gauss-Seidel
+    float relaxation; // fraction of the Jacobi update applied each sweep
+    bool deterministic; // sort bodies and forces by id every step and hash the resulting state
+    bool geometricStiffness; // add the lumped constraint hessians to the primal systems
+    bool accelerate; // Chebyshev extrapolation of body poses between iterations
+    float spectralRadius; // estimated convergence rate of the plain iterations
+    int reorderInterval; // steps between sorting bodies and forces along a Morton curve, 0 to never reorder
+
+    float timestep; // fixed step taken by advance
+    int substeps; // solver steps per fixed step, each running iterations
+    int maxSteps; // fixed steps advance may take per call before dropping time
+    float accumulator; // unsimulated time carried between advance calls
+    float interpolation; // fraction of a fixed step left in the accumulator
+
+    bool allowSleep; // put islands that have come to rest to sleep
+    float sleepLinearVelocity; // islands sleep once all bodies are below both thresholds for sleepTime
+    float sleepAngularVelocity;
+    float sleepTime;
+
+    // dense arrays in no particular order, removals swap the last element into the gap.
+    // reorderBodies moves bodies in memory, so only handles stay valid across steps when it runs
+    std::vector<Rigid*> bodies;
+    std::vector<Force*> forces;
+    HandleTable<Rigid> bodyHandles;
+    HandleTable<Force> forceHandles;
+
+    // body to force adjacency in compressed sparse row form, rebuilt every step once the forces are known,
+    // the forces of bodies[i] are adjacency[adjacencyStart[i]] up to adjacency[adjacencyStart[i + 1]]
+    std::vector<int> adjacencyStart;
+    std::vector<Force*> adjacency;
     Mesh* meshes;
 
+    int nextBodyId;
+    int nextForceId;
+    uint64_t stepHash; // hash of body state after the last deterministic step
+    int stepsSinceReorder;
+
+    std::vector<Island> islands;
+    bool islandsDirty; // a merged force was removed, so the union-find must be rebuilt
+    std::shared_ptr<ThreadPool> pool; // shared with clones, which can step at the same time or from inside its tasks
+    ObjectPool<Manifold> manifoldPool; // contact pairs come and go every step, so they never touch the heap
+    std::vector<FrameArena> arenas; // scratch memory reset every step, one per pool worker plus one for the calling thread
+
+    // quality reached by the last step
+    int stepIterations; // most iterations used by any island
+    float stepPrimalResidual; // largest island residuals
+    float stepDualResidual;
+    bool stepTimedOut; // some island was cut short by the deadline
+    size_t stepArenaBytes; // scratch memory used over all arenas
+
+    std::chrono::steady_clock::time_point deadline; // islands stop iterating once this passes
+
     Solver();
+    explicit Solver(std::shared_ptr<ThreadPool> pool);
     ~Solver();
+    Solver(const Solver&) = delete;
+    Solver& operator=(const Solver&) = delete;
+
+    // independent copy of the world that keeps handles, ids and array orders, so both step identically.
+    // Meshes and the thread pool are shared, everything else is copied, see clone.cpp
+    std::unique_ptr<Solver> clone() const;
+
+    // flat copy of all mutable state for rollback, see snapshot.cpp. Restoring gives bit-identical
+    // steps afterwards as long as the same bodies exist, contacts are recreated as needed
+    void saveSnapshot(std::vector<uint8_t>& buffer) const;
+    bool loadSnapshot(const uint8_t* data, size_t size);
+    bool checkSnapshot(const uint8_t* data, size_t size); // whether loadSnapshot would accept the buffer
 
     Rigid* pick(vec3 at, vec3& local); // ray-pick helper
 
     void clear();
     void defaultParams();
-    void step(float dt);
+
+    // handles resolve to nullptr once their object is destroyed
+    Rigid* get(BodyHandle handle) const { return bodyHandles.get(handle); }
+    Force* get(ForceHandle handle) const { return forceHandles.get(handle); }
+    void destroy(BodyHandle handle); // also destroys every force acting on the body
+    void destroy(ForceHandle handle);
+    void destroyBodies(const BodyHandle* handles, int count);
+    void destroyForces(const ForceHandle* handles, int count);
+
+    // bulk state transfer, see state.cpp. Buffers hold one entry per body in the order of bodies,
+    // null pointers skip that field, so the same calls serve interleaved and separate arrays.
+    // That order changes when bodies are removed or reordered, readHandles tells which body is in
+    // each slot, and the calls taking handles address bodies directly
+    void createBodies(const BodyDesc* descs, int count, BodyHandle* handles = nullptr);
+    void readHandles(BodyHandle* handles) const;
+    void readState(const BodyHandle* handles, int count, Transform* transforms, vec6* velocities = nullptr) const;
+    void writeState(const BodyHandle* handles, int count, const Transform* transforms, const vec6* velocities = nullptr);
+    void readState(Transform* transforms, vec6* velocities = nullptr) const;
+    void readState(pvec3* positions, quat* rotations, vec6* velocities = nullptr) const;
+    void writeState(const Transform* transforms, const vec6* velocities = nullptr);
+    void writeState(const pvec3* positions, const quat* rotations, const vec6* velocities = nullptr);
+
+    void step(float dt, std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+    int advance(float frameTime, std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+    // scratch memory
+    FrameArena& frameArena(); // arena of the calling thread, only valid until the next step
+    size_t arenaHighWater() const; // most any single arena has held in one step, for sizing blockSize
+
+    // primal helpers
+    bool warmstartForce(Force* force);
+    void assemble(Rigid* body, float dt, mat6x6& lhs, vec6& rhs);
+    float applyDelta(Rigid* body, const vec6& delta);
+    float flushBatch(SystemBatch& batch, Rigid** batched);
+    float jacobiSweep(const Island& island, float dt, ArenaVector<vec6>& deltas);
+    void extrapolate(const Island& island, float omega);
+
+    void validateBodies() const;
+
+    // determinism
+    void sortBodies();
+    void sortForces();
+    uint64_t hashState() const;
+
+    // spatial ordering
+    void reorderBodies();
+    void relocateBodies();
+
+    // adjacency and islands
+    void buildAdjacency();
+    bool connected(const Rigid* body, Rigid* const* others, int count) const;
+    void mergeIslands(Force* force);
+    void buildIslands();
+    void solveIsland(Island& island, float dt);
+    void wakeIsland(Rigid* body);
+    void leaveIsland(Rigid* body);
+    void leaveIsland(Force* force);
+    void updateSleep(float dt);
 };
 
 // helper functions
@@ -0,0 +1,80 @@
+#include "solver.h"
+
+// creates the bodies in order, the body array and handle table grow once instead of per body
+void Solver::createBodies(const BodyDesc* descs, int count, BodyHandle* handles) {
+    bodies.reserve(bodies.size() + count);
+    bodyHandles.reserve(bodies.size() + count);
+
+    for (int i = 0; i < count; i++) {
+        Rigid* body = new Rigid(this, descs[i]);
+        if (handles) handles[i] = body->handle;
+    }
+}
+
+void Solver::readHandles(BodyHandle* handles) const {
+    for (int i = 0; i < (int) bodies.size(); i++) handles[i] = bodies[i]->handle;
+}
+
+// stale handles leave their entries untouched
+void Solver::readState(const BodyHandle* handles, int count, Transform* transforms, vec6* velocities) const {
+    for (int i = 0; i < count; i++) {
+        const Rigid* body = get(handles[i]);
+        if (body == nullptr) continue;
+        if (transforms) transforms[i] = { body->position, body->rotation };
+        if (velocities) velocities[i] = body->velocity;
+    }
+}
+
+// stale handles are skipped
+void Solver::writeState(const BodyHandle* handles, int count, const Transform* transforms, const vec6* velocities) {
+    for (int i = 0; i < count; i++) {
+        Rigid* body = get(handles[i]);
+        if (body == nullptr) continue;
+        if (transforms) {
+            body->position = body->prevPosition = transforms[i].position;
+            body->rotation = body->prevRotation = transforms[i].rotation;
+        }
+        if (velocities) body->velocity = velocities[i];
+        wakeIsland(body);
+    }
+}
+
+void Solver::readState(Transform* transforms, vec6* velocities) const {
+    for (int i = 0; i < (int) bodies.size(); i++) {
+        const Rigid* body = bodies[i];
+        if (transforms) transforms[i] = { body->position, body->rotation };
+        if (velocities) velocities[i] = body->velocity;
+    }
+}
+
+void Solver::readState(pvec3* positions, quat* rotations, vec6* velocities) const {
+    for (int i = 0; i < (int) bodies.size(); i++) {
+        const Rigid* body = bodies[i];
+        if (positions) positions[i] = body->position;
+        if (rotations) rotations[i] = body->rotation;
+        if (velocities) velocities[i] = body->velocity;
+    }
+}
+
+void Solver::writeState(const Transform* transforms, const vec6* velocities) {
+    for (int i = 0; i < (int) bodies.size(); i++) {
+        Rigid* body = bodies[i];
+        if (transforms) {
+            // a write is a teleport, so there is nothing to interpolate from
+            body->position = body->prevPosition = transforms[i].position;
+            body->rotation = body->prevRotation = transforms[i].rotation;
+        }
+        if (velocities) body->velocity = velocities[i];
+        wakeIsland(body);
+    }
+}
+
+void Solver::writeState(const pvec3* positions, const quat* rotations, const vec6* velocities) {
+    for (int i = 0; i < (int) bodies.size(); i++) {
+        Rigid* body = bodies[i];
+        if (positions) body->position = body->prevPosition = positions[i];
+        if (rotations) body->rotation = body->prevRotation = rotations[i];
+        if (velocities) body->velocity = velocities[i];
+        wakeIsland(body);
+    }
+}
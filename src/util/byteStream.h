@@ -0,0 +1,78 @@
+#ifndef BYTESTREAM_H
+#define BYTESTREAM_H
+
+#include "includes.h"
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+// appends raw copies of trivially copyable values to a byte buffer. Other types are written through
+// a writeFields(ByteWriter&, const T&) overload found next to the type, and read back through
+// readFields(ByteReader&, T&). The buffer grows geometrically and is only trimmed to the bytes
+// written when the writer goes away
+class ByteWriter {
+    std::vector<uint8_t>& out;
+    size_t used;
+
+    public:
+    explicit ByteWriter(std::vector<uint8_t>& out) : out(out), used(out.size()) {}
+    ~ByteWriter() { out.resize(used); }
+    ByteWriter(const ByteWriter&) = delete;
+    ByteWriter& operator=(const ByteWriter&) = delete;
+
+    template <typename T>
+    void write(const T* values, size_t count) {
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            size_t bytes = sizeof(T) * count;
+            if (used + bytes > out.size()) out.resize(std::max(out.size() * 2, used + bytes));
+            if (bytes) std::memcpy(out.data() + used, values, bytes);
+            used += bytes;
+        } else {
+            for (size_t i = 0; i < count; i++) writeFields(*this, values[i]);
+        }
+    }
+
+    template <typename T>
+    void write(const T& value) { write(&value, 1); }
+
+    size_t size() const { return used; }
+};
+
+// reads values back in the order they were written, every read fails once the buffer runs out.
+// Bools other than 0 or 1 fail as well, since loading them would be undefined
+class ByteReader {
+    const uint8_t* data;
+    const uint8_t* end;
+
+    public:
+    ByteReader(const uint8_t* data, size_t size) : data(data), end(data + size) {}
+
+    template <typename T>
+    bool read(T* values, size_t count) {
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            if ((size_t) (end - data) < sizeof(T) * count) {
+                data = end;
+                return false;
+            }
+            if constexpr (std::is_same<T, bool>::value) {
+                for (size_t i = 0; i < count; i++)
+                    if (data[i] > 1) return false;
+            }
+            if (count) std::memcpy(values, data, sizeof(T) * count);
+            data += sizeof(T) * count;
+            return true;
+        } else {
+            for (size_t i = 0; i < count; i++)
+                if (!readFields(*this, values[i])) return false;
+            return true;
+        }
+    }
+
+    template <typename T>
+    bool read(T& value) { return read(&value, 1); }
+
+    size_t remaining() const { return end - data; }
+};
+
+#endif
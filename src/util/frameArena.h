@@ -0,0 +1,127 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include "includes.h"
+#include <cstddef>
+#include <cstdint>
+
+// linear allocator for data that only lives until the end of a step, frees nothing until reset
+class FrameArena {
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t current = 0; // block being bumped
+    size_t offset = 0; // bump offset into the current block
+    size_t used = 0; // bytes handed out since the last reset, including alignment padding
+    size_t highWater = 0;
+    size_t blockSize;
+
+    public:
+    // position of the bump pointer, see Scope
+    struct Marker {
+        size_t block;
+        size_t offset;
+        size_t used;
+    };
+
+    // hands everything allocated during its lifetime back to the arena when it goes out of scope
+    class Scope {
+        FrameArena& arena;
+        Marker marker;
+
+        public:
+        Scope(FrameArena& arena) : arena(arena), marker(arena.mark()) {}
+        ~Scope() { arena.rewind(marker); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    explicit FrameArena(size_t blockSize = 64 * 1024) : blockSize(blockSize) {}
+
+    FrameArena(FrameArena&&) = default;
+    FrameArena& operator=(FrameArena&&) = default;
+
+    void* allocate(size_t size, size_t align) {
+        while (true) {
+            if (current < blocks.size()) {
+                uintptr_t base = (uintptr_t) blocks[current].data.get();
+                size_t aligned = ((base + offset + align - 1) & ~(uintptr_t) (align - 1)) - base;
+                if (aligned + size <= blocks[current].size) {
+                    used += aligned + size - offset;
+                    highWater = std::max(highWater, used);
+                    offset = aligned + size;
+                    return blocks[current].data.get() + aligned;
+                }
+
+                // the rest of this block is wasted, move on to the next one
+                used += blocks[current].size - offset;
+                current++;
+                offset = 0;
+                continue;
+            }
+
+            size_t bytes = std::max(blockSize, size + align);
+            blocks.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[bytes]), bytes });
+        }
+    }
+
+    Marker mark() const { return { current, offset, used }; }
+
+    // everything allocated after the marker becomes invalid
+    void rewind(const Marker& marker) {
+        current = marker.block;
+        offset = marker.offset;
+        used = marker.used;
+    }
+
+    // everything allocated since the last reset becomes invalid, blocks are kept for the next step
+    void reset() {
+        // a step that spilled into several blocks gets a single block large enough for all of them
+        if (blocks.size() > 1) {
+            size_t total = 0;
+            for (const Block& block : blocks) total += block.size;
+            blocks.clear();
+            blocks.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[total]), total });
+        }
+
+        current = 0;
+        offset = 0;
+        used = 0;
+    }
+
+    size_t bytesUsed() const { return used; }
+    size_t highWaterMark() const { return highWater; } // most bytes used between two resets
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Block& block : blocks) total += block.size;
+        return total;
+    }
+};
+
+// standard allocator adaptor so containers can live in a FrameArena, deallocation is a no-op
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    FrameArena* arena;
+
+    ArenaAllocator(FrameArena& arena) : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& rhs) const { return arena == rhs.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& rhs) const { return arena != rhs.arena; }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef HANDLETABLE_H
+#define HANDLETABLE_H
+
+#include "includes.h"
+#include "byteStream.h"
+#include "frameArena.h"
+#include <cstdint>
+
+// weak reference to an object in a HandleTable, goes stale once the object is removed even if its slot is reused
+template <typename T>
+struct Handle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const Handle& rhs) const { return index == rhs.index && generation == rhs.generation; }
+    bool operator!=(const Handle& rhs) const { return !(*this == rhs); }
+};
+
+// maps handles to objects, freed slots are reused with a bumped generation so old handles no longer resolve
+template <typename T>
+class HandleTable {
+    struct Slot {
+        T* object;
+        uint32_t generation;
+        uint32_t nextFree;
+    };
+
+    std::vector<Slot> slots;
+    uint32_t freeHead = UINT32_MAX;
+
+    public:
+    void reserve(size_t count) { slots.reserve(count); }
+
+    Handle<T> insert(T* object) {
+        if (freeHead == UINT32_MAX) {
+            freeHead = (uint32_t) slots.size();
+            slots.push_back({ nullptr, 0, UINT32_MAX });
+        }
+
+        uint32_t index = freeHead;
+        Slot& slot = slots[index];
+        freeHead = slot.nextFree;
+        slot.object = object;
+        return { index, slot.generation };
+    }
+
+    void erase(Handle<T> handle) {
+        if (get(handle) == nullptr) return;
+        Slot& slot = slots[handle.index];
+        slot.object = nullptr;
+        slot.generation++;
+        slot.nextFree = freeHead;
+        freeHead = handle.index;
+    }
+
+    // replaces every live object with map(object), so a copied table can point at copied objects
+    template <typename F>
+    void remap(F map) {
+        for (Slot& slot : slots)
+            if (slot.object) slot.object = map(slot.object);
+    }
+
+    // writes the slots with each live object as indexOf(object), so load can restore every handle and the free list
+    template <typename F>
+    void save(ByteWriter& out, F indexOf) const {
+        out.write((uint32_t) slots.size());
+        out.write(freeHead);
+        for (const Slot& slot : slots) {
+            out.write(slot.generation);
+            out.write(slot.nextFree);
+            out.write((int32_t) (slot.object ? indexOf(slot.object) : -1));
+        }
+    }
+
+    // reads past what save wrote without changing the table. False unless each of the objectCount
+    // objects sits in the slot that handleOf(index) names and the free list only links empty slots
+    template <typename F>
+    bool check(ByteReader& in, size_t objectCount, F handleOf, FrameArena& arena) const {
+        uint32_t count = 0, head = UINT32_MAX;
+        if (!in.read(count) || !in.read(head)) return false;
+        if (in.remaining() < (size_t) count * 12) return false;
+
+        FrameArena::Scope scope(arena);
+        ArenaVector<uint32_t> next(count, UINT32_MAX, arena);
+        ArenaVector<char> free(count, 1, arena);
+        size_t live = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t generation = 0;
+            int32_t index = -1;
+            in.read(generation);
+            in.read(next[i]);
+            in.read(index);
+            if (index < -1 || (index >= 0 && (size_t) index >= objectCount)) return false;
+            if (index >= 0) {
+                if (handleOf(index) != Handle<T>{ i, generation }) return false;
+                free[i] = 0;
+                live++;
+            }
+        }
+        if (live != objectCount) return false;
+
+        // each free slot is visited at most once, so a cycle runs into a slot it already cleared
+        for (uint32_t i = head; i != UINT32_MAX; i = next[i]) {
+            if (i >= count || !free[i]) return false;
+            free[i] = 0;
+        }
+        return true;
+    }
+
+    // objectAt maps the saved indices back to objects and returns nullptr for indices it doesn't know
+    template <typename F>
+    bool load(ByteReader& in, F objectAt) {
+        uint32_t count = 0;
+        if (!in.read(count) || !in.read(freeHead)) return false;
+        if (in.remaining() < (size_t) count * 12) return false;
+
+        slots.resize(count);
+        for (Slot& slot : slots) {
+            int32_t index = -1;
+            in.read(slot.generation);
+            in.read(slot.nextFree);
+            in.read(index);
+            slot.object = index < 0 ? nullptr : objectAt(index);
+            if (index >= 0 && slot.object == nullptr) return false;
+        }
+        return true;
+    }
+
+    // nullptr if the handle is stale or was never valid
+    T* get(Handle<T> handle) const {
+        if (handle.index >= slots.size()) return nullptr;
+        const Slot& slot = slots[handle.index];
+        return slot.generation == handle.generation ? slot.object : nullptr;
+    }
+};
+
+#endif
@@ -38,4 +38,26 @@ using mat3x3 = glm::mat3x3;
 using mat4x4 = glm::mat4x4;
 using quat = glm::quat;
 
+// scalar precision policy, selected with PHYSICS_PRECISION
+// scalar is used for body positions, solveScalar for the 6x6 primal systems and linalg types
+#if defined(PRECISION_DOUBLE)
+using scalar = double;
+using solveScalar = double;
+using pvec3 = glm::dvec3;
+using svec3 = glm::dvec3;
+using smat3x3 = glm::dmat3x3;
+#elif defined(PRECISION_MIXED)
+using scalar = double;
+using solveScalar = float;
+using pvec3 = glm::dvec3;
+using svec3 = glm::vec3;
+using smat3x3 = glm::mat3x3;
+#else
+using scalar = float;
+using solveScalar = float;
+using pvec3 = glm::vec3;
+using svec3 = glm::vec3;
+using smat3x3 = glm::mat3x3;
+#endif
+
 #endif
\ No newline at end of file
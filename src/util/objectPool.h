@@ -0,0 +1,66 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include "includes.h"
+#include <new>
+#include <utility>
+
+// slab allocator for objects of a single type, recycled slots are reused first through an intrusive free list
+// slabs are only released with the pool, so every object must be recycled before then
+template <typename T, size_t SlabSize = 256>
+class ObjectPool {
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    Slot* freeList = nullptr;
+    size_t live = 0;
+
+    void grow() {
+        slabs.emplace_back(new Slot[SlabSize]);
+        Slot* slab = slabs.back().get();
+
+        // thread the new slots onto the free list so the first one is handed out first
+        for (size_t i = 0; i < SlabSize; i++) slab[i].next = i + 1 < SlabSize ? &slab[i + 1] : freeList;
+        freeList = slab;
+    }
+
+    public:
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        if (freeList == nullptr) grow();
+        Slot* slot = freeList;
+        freeList = slot->next;
+
+        T* object;
+        try {
+            object = new (slot->storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            slot->next = freeList;
+            freeList = slot;
+            throw;
+        }
+
+        live++;
+        return object;
+    }
+
+    void recycle(T* object) {
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = freeList;
+        freeList = slot;
+        live--;
+    }
+
+    size_t size() const { return live; }
+    size_t capacity() const { return slabs.size() * SlabSize; }
+};
+
+#endif